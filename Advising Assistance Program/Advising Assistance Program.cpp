@@ -14,6 +14,7 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
+#include "BufferedWriter.hpp"
 #include "CSVparser.hpp"
 
 using namespace std;
@@ -56,8 +57,8 @@ class CourseBST {
 private:
 	Node* root;
 
-	void addNode(Node* node, Course course);
-	void printSampleSchedule(Node* node);
+	void addNode(Node* node, const Course& course);
+	void printSampleSchedule(Node* node, BufferedWriter& out);
 	void printCourseInformation(Node* node, string courseNum);
 
 public:
@@ -87,14 +88,25 @@ CourseBST::~CourseBST() {
 }
 
 // =======================================================
-// Deconstruct Binary Search Tree recursively
+// Deconstruct Binary Search Tree without recursion: any
+// left child is rotated up until the node has none, then
+// the node is deleted and its right subtree is next, so
+// even a degenerate tree needs no stack at all
 // =======================================================
 
 void CourseBST::DeleteRecursive(Node* node) {
-	if (node) {
-		DeleteRecursive(node->left);
-		DeleteRecursive(node->right);
-		delete node;
+	while (node != nullptr) {
+		if (node->left != nullptr) {
+			Node* left = node->left;
+			node->left = left->right;
+			left->right = node;
+			node = left;
+		}
+		else {
+			Node* right = node->right;
+			delete node;
+			node = right;
+		}
 	}
 }
 
@@ -131,7 +143,8 @@ int CourseBST::NumPrerequisiteCourses(Course course) {
 // =======================================================
 
 void CourseBST::PrintSampleSchedule() {
-	this->printSampleSchedule(root);
+	BufferedWriter out;
+	this->printSampleSchedule(root, out);
 }
 
 // =======================================================
@@ -143,38 +156,42 @@ void CourseBST::PrintCourseInformation(string courseId) {
 }
 
 // =======================================================
-// Function to add a node
+// Function to add a node, walking down the links to the
+// empty one where the course belongs
 // =======================================================
 
-void CourseBST::addNode(Node* node, Course course) {
-	// Current courseId is less than the current node's courseId
-	if (node->course.courseId.compare(course.courseId) > 0) {
-		if (node->left == nullptr)
-			node->left = new Node(course);
-		else
-			this->addNode(node->left, course);
-	}
-	// Current courseId is equal or greater than 
-	// the current node's courseId
-	else {
-		if (node->right == nullptr)
-			node->right = new Node(course);
+void CourseBST::addNode(Node* node, const Course& course) {
+	Node** link = &node;
+	while (*link != nullptr) {
+		// Current courseId is less than the current node's courseId
+		if ((*link)->course.courseId.compare(course.courseId) > 0)
+			link = &(*link)->left;
+		// Current courseId is equal or greater than 
+		// the current node's courseId
 		else
-			this->addNode(node->right, course);
+			link = &(*link)->right;
 	}
+	*link = new Node(course);
 }
 
 // =======================================================
-// Function to print sample schedule alphanumerically
+// Function to print sample schedule alphanumerically,
+// keeping the path back up the tree on an explicit stack
 // =======================================================
 
-void CourseBST::printSampleSchedule(Node* node) {
-	if (node != nullptr) {
-		printSampleSchedule(node->left);
-		cout << node->course.courseId << ", " << node->course.courseName << endl;
-		printSampleSchedule(node->right);
+void CourseBST::printSampleSchedule(Node* node, BufferedWriter& out) {
+	vector<Node*> stack;
+	while (node != nullptr || !stack.empty()) {
+		// Go as far left as possible, remembering the way back
+		while (node != nullptr) {
+			stack.push_back(node);
+			node = node->left;
+		}
+		node = stack.back();
+		stack.pop_back();
+		out << node->course.courseId << ", " << node->course.courseName << '\n';
+		node = node->right;
 	}
-	return;
 }
 
 // =======================================================
@@ -6,10 +6,26 @@
 // Description : Binary Search Tree
 //============================================================================
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <thread>
 #include <time.h>
+#include <xmmintrin.h>
 
+#include "BloomFilter.hpp"
+#include "BufferedWriter.hpp"
 #include "CSVparser.hpp"
+#include "NodePool.hpp"
 
 using namespace std;
 
@@ -31,16 +47,25 @@ struct Bid {
     }
 };
 
+struct ScanStats {
+    unsigned long long searches; // searches that walked the tree
+    unsigned long long nodes;    // nodes those searches visited
+};
+
 // Internal structure for tree node
 struct Node {
     Bid bid;
     Node *left;
     Node *right;
+    int height; // kept up to date only while the tree is balanced
+    int size; // number of bids in the subtree rooted here
 
     // default constructor
     Node() {
         left = nullptr;
         right = nullptr;
+        height = 1;
+        size = 1;
     }
 
     // initialize with a bid
@@ -63,21 +88,119 @@ class BinarySearchTree {
 private:
     Node* root;
 
-    void addNode(Node* node, Bid bid);
-    void inOrder(Node* node);
-    void preOrder(Node* node);
-    void postOrder(Node* node);
-    Node* removeNode(Node* node, string bidId);
+    // optional Bloom filter answering most misses without a descent
+    bool filtered = false;
+    BloomFilter bloom;
+
+    // optional AVL balancing keeping the height O(log n)
+    bool balanced = false;
+
+    // optional splaying, moving each node found to the root
+    bool splayed = false;
+    ScanStats scanStats = ScanStats();
+
+    // tree nodes come from the tree's own slab pool
+    NodePool<Node> nodePool;
+
+    // optional read-only copy searched without pointers (see Freeze)
+    bool frozen = false;
+    vector<uint64_t> frozenWords; // storage for the keys, with room to align them
+    uint64_t* frozenKeys = nullptr; // packed ids from position 1, Eytzinger order
+    vector<Bid> frozenBids; // the bid for each key, same positions
+    size_t frozenCount = 0;
+
+    void addNode(Node*& node, const Bid& bid);
+    void inOrder(Node* node, BufferedWriter& out);
+    void preOrder(Node* node, BufferedWriter& out);
+    void postOrder(Node* node, BufferedWriter& out);
+    Node* removeNode(Node* node, string bidId, bool& removed);
+    void rebuildBloom();
+    static int height(Node* node);
+    static int size(Node* node);
+    int countBelow(const string& bidId, bool inclusive);
+    static uint64_t packKey(const string& bidId);
+    void fillFrozen(vector<Bid>& sorted, size_t& next, size_t k);
+    Bid searchFrozen(const string& bidId);
+    void thaw();
+    static void updateNode(Node* node);
+    static Node* rotateLeft(Node* node);
+    static Node* rotateRight(Node* node);
+    static Node* rebalance(Node* node);
+    static Node* buildBalanced(vector<Node*>& nodes, size_t first, size_t last);
+    Node* splay(Node* node, const string& bidId);
+    static void rebalancePath(vector<Node**>& path);
 
 public:
+    /**
+     * Bidirectional iterator over the bids in bid id order. It
+     * keeps the path from the root down to its node, so stepping
+     * costs O(1) amortized and needs no parent pointers. Any
+     * change to the tree invalidates every iterator.
+     */
+    class Iterator {
+    public:
+        typedef bidirectional_iterator_tag iterator_category;
+        typedef Bid value_type;
+        typedef ptrdiff_t difference_type;
+        typedef const Bid* pointer;
+        typedef const Bid& reference;
+
+        Iterator() : root(nullptr) {
+        }
+        reference operator*() const {
+            return path.back()->bid;
+        }
+        pointer operator->() const {
+            return &path.back()->bid;
+        }
+        Iterator& operator++();
+        Iterator& operator--();
+        Iterator operator++(int);
+        Iterator operator--(int);
+        bool operator==(const Iterator& other) const;
+        bool operator!=(const Iterator& other) const;
+
+    private:
+        friend class BinarySearchTree;
+
+        Node* root;
+        // every node from the root down to the current one; empty at the end
+        vector<Node*> path;
+
+        Iterator(Node* root) : root(root) {
+        }
+        void descendLeft(Node* node);
+        void descendRight(Node* node);
+    };
+
     BinarySearchTree();
     virtual ~BinarySearchTree();
     void InOrder();
+    void InOrder(BufferedWriter& out);
     void PreOrder();
     void PostOrder();
     void Insert(Bid bid);
+    void BulkLoad(vector<Bid> bids);
     void Remove(string bidId);
     Bid Search(string bidId);
+    void SetBloomFilter(bool enabled);
+    BloomFilterStats BloomStats();
+    NodePoolStats PoolStats();
+    void SetBalanced(bool enabled);
+    void SetSplay(bool enabled);
+    ScanStats SearchStats();
+    int Height();
+    Iterator begin();
+    Iterator end();
+    Iterator LowerBound(string bidId);
+    Iterator UpperBound(string bidId);
+    vector<Bid> RangeScan(string lo, string hi);
+    int Size();
+    int Rank(string bidId);
+    Bid Select(int k);
+    int CountInRange(string lo, string hi);
+    void Freeze();
+    bool Frozen();
 };
 
 /**
@@ -93,7 +216,23 @@ BinarySearchTree::BinarySearchTree() {
  * Destructor
  */
 BinarySearchTree::~BinarySearchTree() {
-    // recurse from root deleting every node
+    // destroy every node, keeping the ones still to visit on a
+    // stack; the pool frees its slabs once the tree is gone
+    vector<Node*> stack;
+    if (root != nullptr) {
+        stack.push_back(root);
+    }
+    while (!stack.empty()) {
+        Node* node = stack.back();
+        stack.pop_back();
+        if (node->left != nullptr) {
+            stack.push_back(node->left);
+        }
+        if (node->right != nullptr) {
+            stack.push_back(node->right);
+        }
+        nodePool.Destroy(node);
+    }
 }
 
 /**
@@ -102,7 +241,17 @@ BinarySearchTree::~BinarySearchTree() {
 void BinarySearchTree::InOrder() {
     // FixMe (2): In order root
     // call inOrder fuction and pass root
-    this->inOrder(root);
+    BufferedWriter out;
+    this->inOrder(root, out);
+}
+
+/**
+ * Traverse the tree in order, writing to a buffered writer
+ *
+ * @param out The writer for standard output, a pipe or a file
+ */
+void BinarySearchTree::InOrder(BufferedWriter& out) {
+    this->inOrder(root, out);
 }
 
 /**
@@ -111,7 +260,8 @@ void BinarySearchTree::InOrder() {
 void BinarySearchTree::PostOrder() {
     // FixMe (3): Post order root
     // postOrder root
-    this->postOrder(root);
+    BufferedWriter out;
+    this->postOrder(root, out);
 }
 
 /**
@@ -120,7 +270,8 @@ void BinarySearchTree::PostOrder() {
 void BinarySearchTree::PreOrder() {
     // FixMe (4): Pre order root
     // preOrder root
-    this->preOrder(root);
+    BufferedWriter out;
+    this->preOrder(root, out);
 }
 
 /**
@@ -128,15 +279,16 @@ void BinarySearchTree::PreOrder() {
  */
 void BinarySearchTree::Insert(Bid bid) {
     // FIXME (5) Implement inserting a bid into the tree
-    // if root equarl to null ptr
-    if (root == nullptr) {
-        // root is equal to new node bid
-        root = new Node(bid);
+    if (frozen) {
+        thaw();
     }
-    // else
-    else {
-        // add Node root and bid
-        this->addNode(root, bid);
+    // add Node root and bid, which fills in an empty root too
+    this->addNode(root, bid);
+    if (filtered) {
+        bloom.Add(bid.bidId);
+        if (bloom.NeedsRebuild()) {
+            rebuildBloom();
+        }
     }
 }
 
@@ -145,9 +297,23 @@ void BinarySearchTree::Insert(Bid bid) {
  */
 void BinarySearchTree::Remove(string bidId) {
     // FIXME (6) Implement removing a bid from the tree
-    // remove node root bidID
-    this->removeNode(root, bidId);
-
+    // a bid the filter has never seen cannot be in the tree
+    if (filtered && !bloom.MayContain(bidId)) {
+        return;
+    }
+    if (frozen) {
+        thaw();
+    }
+    // remove node root bidID, which may replace the root itself
+    bool removed = false;
+    root = this->removeNode(root, bidId, removed);
+    // only a bid actually unlinked leaves a stale key in the filter
+    if (removed && filtered) {
+        bloom.Removed();
+        if (bloom.NeedsRebuild()) {
+            rebuildBloom();
+        }
+    }
 }
 
 /**
@@ -155,11 +321,27 @@ void BinarySearchTree::Remove(string bidId) {
  */
 Bid BinarySearchTree::Search(string bidId) {
     // FIXME (7) Implement searching the tree for a bid
+    // most misses end here without walking down the tree
+    if (filtered && !bloom.MayContain(bidId)) {
+        return Bid();
+    }
+    if (frozen) {
+        return searchFrozen(bidId);
+    }
+    scanStats.searches++;
+    if (splayed) {
+        root = splay(root, bidId);
+        if (root != nullptr && root->bid.bidId == bidId) {
+            return root->bid;
+        }
+        return Bid();
+    }
     // set current node equal to root
     Node* current = root;
 
     // keep looping downwards until bottom reached or matching bidId found
     while (current != nullptr) {
+        scanStats.nodes++;
         // if match found, return current bid
         if (current->bid.bidId.compare(bidId) == 0) {
             return current->bid;
@@ -179,227 +361,2699 @@ Bid BinarySearchTree::Search(string bidId) {
 }
 
 /**
- * Add a bid to some node (recursive)
- *
- * @param node Current node in tree
- * @param bid Bid to be added
+ * Push a node and then its leftmost descendants, ending on the
+ * first node of the subtree
  */
-void BinarySearchTree::addNode(Node* node, Bid bid) {
-    // FIXME (8) Implement inserting a bid into the tree
-    // if node is larger then add to left
-    if (node->bid.bidId.compare(bid.bidId) > 0) {
-        // if no left node
-        if (node->left == nullptr) {
-            // this node becomes left
-            node->left = new Node(bid);
+void BinarySearchTree::Iterator::descendLeft(Node* node) {
+    while (node != nullptr) {
+        path.push_back(node);
+        node = node->left;
+    }
+}
+
+/**
+ * Push a node and then its rightmost descendants, ending on the
+ * last node of the subtree
+ */
+void BinarySearchTree::Iterator::descendRight(Node* node) {
+    while (node != nullptr) {
+        path.push_back(node);
+        node = node->right;
+    }
+}
+
+/**
+ * Step to the next bid in order
+ */
+BinarySearchTree::Iterator& BinarySearchTree::Iterator::operator++() {
+    Node* node = path.back();
+    if (node->right != nullptr) {
+        descendLeft(node->right);
+        return *this;
+    }
+    // climb until coming up from a left child, or off the top
+    Node* child;
+    do {
+        child = path.back();
+        path.pop_back();
+    } while (!path.empty() && path.back()->right == child);
+    return *this;
+}
+
+/**
+ * Step to the previous bid in order; from the end this is the
+ * last bid
+ */
+BinarySearchTree::Iterator& BinarySearchTree::Iterator::operator--() {
+    if (path.empty()) {
+        descendRight(root);
+        return *this;
+    }
+    Node* node = path.back();
+    if (node->left != nullptr) {
+        descendRight(node->left);
+        return *this;
+    }
+    // climb until coming up from a right child
+    Node* child;
+    do {
+        child = path.back();
+        path.pop_back();
+    } while (!path.empty() && path.back()->left == child);
+    return *this;
+}
+
+BinarySearchTree::Iterator BinarySearchTree::Iterator::operator++(int) {
+    Iterator old = *this;
+    ++*this;
+    return old;
+}
+
+BinarySearchTree::Iterator BinarySearchTree::Iterator::operator--(int) {
+    Iterator old = *this;
+    --*this;
+    return old;
+}
+
+/**
+ * Two iterators are equal when they stand on the same node, or
+ * are both at the end
+ */
+bool BinarySearchTree::Iterator::operator==(const Iterator& other) const {
+    if (path.empty() || other.path.empty()) {
+        return path.empty() && other.path.empty();
+    }
+    return path.back() == other.path.back();
+}
+
+bool BinarySearchTree::Iterator::operator!=(const Iterator& other) const {
+    return !(*this == other);
+}
+
+/**
+ * Returns an iterator at the first bid in order
+ */
+BinarySearchTree::Iterator BinarySearchTree::begin() {
+    Iterator it(root);
+    it.descendLeft(root);
+    return it;
+}
+
+/**
+ * Returns an iterator one past the last bid
+ */
+BinarySearchTree::Iterator BinarySearchTree::end() {
+    return Iterator(root);
+}
+
+/**
+ * Returns an iterator at the first bid whose id is not less
+ * than a bid id, or the end, in O(log n) for a balanced tree
+ */
+BinarySearchTree::Iterator BinarySearchTree::LowerBound(string bidId) {
+    Iterator it(root);
+    size_t found = 0;
+    for (Node* node = root; node != nullptr;) {
+        it.path.push_back(node);
+        // a match here may still have equal ids to its left
+        if (!(node->bid.bidId < bidId)) {
+            found = it.path.size();
+            node = node->left;
         }
-        // else recurse down the left node
         else {
-            this->addNode(node->left, bid);
+            node = node->right;
         }
     }
-    // else
-    else {
-        // if no right node
-        if (node->right == nullptr) {
-            // this node becomes right
-            node->right = new Node(bid);
+    // the last node where the walk turned left is the answer
+    it.path.resize(found);
+    return it;
+}
+
+/**
+ * Returns an iterator at the first bid whose id is greater than
+ * a bid id, or the end, in O(log n) for a balanced tree
+ */
+BinarySearchTree::Iterator BinarySearchTree::UpperBound(string bidId) {
+    Iterator it(root);
+    size_t found = 0;
+    for (Node* node = root; node != nullptr;) {
+        it.path.push_back(node);
+        if (bidId < node->bid.bidId) {
+            found = it.path.size();
+            node = node->left;
         }
-        //else
         else {
-            // recurse down the left node
-            this->addNode(node->right, bid);
+            node = node->right;
         }
     }
+    it.path.resize(found);
+    return it;
 }
-void BinarySearchTree::inOrder(Node* node) {
-      // FixMe (9): Pre order root
-      //if node is not equal to null ptr
-    if (node != nullptr) {
-        //InOrder not left
-        inOrder(node->left);
+
+/**
+ * Find every bid whose id lies within a range, visiting only
+ * the path to the first of them and the bids returned
+ *
+ * @param lo Lowest bid id to include
+ * @param hi Highest bid id to include
+ * @return the matching bids in bid id order
+ */
+vector<Bid> BinarySearchTree::RangeScan(string lo, string hi) {
+    vector<Bid> bids;
+    Iterator last = end();
+    for (Iterator it = LowerBound(lo); it != last && !(hi < it->bidId); ++it) {
+        bids.push_back(*it);
+    }
+    return bids;
+}
+
+/**
+ * Add a bid below some node, walking down the links to the
+ * empty one where the bid belongs. A balanced tree then
+ * rebalances every node passed, from the new leaf up.
+ *
+ * @param node The link to the subtree's root, which may be empty
+ * @param bid Bid to be added
+ */
+void BinarySearchTree::addNode(Node*& node, const Bid& bid) {
+    // FIXME (8) Implement inserting a bid into the tree
+    vector<Node**> path;
+    Node** link = &node;
+    while (*link != nullptr) {
+        // every node passed gains the new bid in its subtree
+        (*link)->size++;
+        if (balanced) {
+            path.push_back(link);
+        }
+        // if node is larger then add to left, else to the right
+        if ((*link)->bid.bidId.compare(bid.bidId) > 0) {
+            link = &(*link)->left;
+        }
+        else {
+            link = &(*link)->right;
+        }
+    }
+    // this node becomes the empty child
+    *link = nodePool.Create(bid);
+    rebalancePath(path);
+}
+
+/**
+ * Output every bid in order, keeping the path back up the
+ * tree on an explicit stack
+ */
+void BinarySearchTree::inOrder(Node* node, BufferedWriter& out) {
+    // FixMe (9): Pre order root
+    vector<Node*> stack;
+    while (node != nullptr || !stack.empty()) {
+        // go as far left as possible, remembering the way back
+        while (node != nullptr) {
+            stack.push_back(node);
+            node = node->left;
+        }
+        node = stack.back();
+        stack.pop_back();
         //output bidID, title, amount, fund
-        cout << node->bid.bidId << ": "
+        out << node->bid.bidId << ": "
             << node->bid.title << " | "
             << node->bid.amount << " | "
-            << node->bid.fund << endl;
+            << node->bid.fund << '\n';
         //InOder right
-        inOrder(node->right);
+        node = node->right;
     }
 }
 
-void BinarySearchTree::postOrder(Node * node) {
+/**
+ * Output every bid after both of its subtrees, using an explicit
+ * stack and the last node written to tell which side is done
+ */
+void BinarySearchTree::postOrder(Node * node, BufferedWriter& out) {
     // FixMe (10): Pre order root
-    //if node is not equal to null ptr
-    if (node != nullptr) {
-        //postOrder left
-        postOrder(node->left);
-        //postOrder right
-        postOrder(node->right);
+    vector<Node*> stack;
+    Node* written = nullptr;
+    while (node != nullptr || !stack.empty()) {
+        while (node != nullptr) {
+            stack.push_back(node);
+            node = node->left;
+        }
+        Node* top = stack.back();
+        // postOrder right first, unless it was just finished
+        if (top->right != nullptr && top->right != written) {
+            node = top->right;
+            continue;
+        }
         //output bidID, title, amount, fund
-        cout << node->bid.bidId << ": "
-            << node->bid.title << " | "
-            << node->bid.amount << " | "
-            << node->bid.fund << endl;
+        out << top->bid.bidId << ": "
+            << top->bid.title << " | "
+            << top->bid.amount << " | "
+            << top->bid.fund << '\n';
+        written = top;
+        stack.pop_back();
     }
 }
 
-void BinarySearchTree::preOrder(Node* node) {
+/**
+ * Output every bid before its subtrees, using an explicit stack
+ */
+void BinarySearchTree::preOrder(Node* node, BufferedWriter& out) {
     // FixMe (11): Pre order root
-    //if node is not equal to null ptr
+    vector<Node*> stack;
     if (node != nullptr) {
+        stack.push_back(node);
+    }
+    while (!stack.empty()) {
+        node = stack.back();
+        stack.pop_back();
         //output bidID, title, amount, fund
-        cout << node->bid.bidId << ": "
+        out << node->bid.bidId << ": "
             << node->bid.title << " | "
             << node->bid.amount << " | "
-            << node->bid.fund << endl;
-        //postOrder left
-        postOrder(node->left);
-        //postOrder right
-        postOrder(node->right);
+            << node->bid.fund << '\n';
+        // push right first so the left subtree comes out first
+        if (node->right != nullptr) {
+            stack.push_back(node->right);
+        }
+        if (node->left != nullptr) {
+            stack.push_back(node->left);
+        }
     }
 }
 
-Node* BinarySearchTree::removeNode(Node* node, string bidId) {
-    //if this node is null then return (avoid crashing)
-    if (node == nullptr) {
+/**
+ * Remove the first node found holding a bid id, walking down
+ * the links rather than recursing. A balanced tree then
+ * rebalances every node on the path, from the bottom up.
+ *
+ * @param node Root of the subtree
+ * @param bidId The bid id to remove
+ * @param removed Set to true if a node was unlinked
+ * @return the new root of the subtree
+ */
+Node* BinarySearchTree::removeNode(Node* node, string bidId, bool& removed) {
+    // the link to every node passed, for rebalancing afterwards
+    vector<Node**> path;
+    Node** link = &node;
+    while (*link != nullptr && (*link)->bid.bidId.compare(bidId) != 0) {
+        path.push_back(link);
+        // go down the left subtree if smaller, else the right
+        if (bidId.compare((*link)->bid.bidId) < 0) {
+            link = &(*link)->left;
+        }
+        else {
+            link = &(*link)->right;
+        }
+    }
+    //if no node matched then there is nothing to remove
+    if (*link == nullptr) {
         return node;
     }
-    
-    // recurse down left subtree
-    if (bidId.compare(node->bid.bidId) < 0) {
-        //remove left node
-        node->left = removeNode(node->left, bidId);
+
+    Node* target = *link;
+    // every node above loses the bid from its subtree
+    for (Node** above : path) {
+        (*above)->size--;
+    }
+    // node has at most one child, which takes its place
+    if (target->left == nullptr) {
+        *link = target->right;
     }
-    //else recurse down right subtree
-    else if (bidId.compare(node->bid.bidId) > 0) {
-        //remove right node
-        node->right = removeNode(node->right, bidId);
+    else if (target->right == nullptr) {
+        *link = target->left;
     }
+
+    // node has two children
     else {
-        
-        // node has no children so is a leaf node
-        if (node->left == nullptr && node->right == nullptr) {
-            // delete this node
-            delete node;
-            // set node to null
-            node = nullptr;
-        }
-        
-        // node has one child to the left
-        else if (node->left != nullptr && node->right == nullptr) {
-            //set temp Node* equal to node
-            Node* temp = node;
-            //set node equal to left node
-            node = node->left;
-            //delete temp node 
-            delete temp;
+        // detach the smallest node of the right subtree and
+        // link it in where this node was, so no bid is copied
+        vector<Node**> minPath;
+        Node** minLink = &target->right;
+        while ((*minLink)->left != nullptr) {
+            minPath.push_back(minLink);
+            minLink = &(*minLink)->left;
         }
-
-        // node has one child to the right
-        else if (node->right != nullptr && node->left == nullptr) {
-            //set temp Node* equal to node
-            Node* temp = node;
-            //set node equal to right node
-            node = node->right;
-            //delete temp node
-            delete temp;
+        Node* min = *minLink;
+        for (Node** above : minPath) {
+            (*above)->size--;
         }
-
-        // node has two children
-        else {
-            //set temp Node* to right node
-            Node* temp = node->right;
-            //while left temp node is not nullpointer
-            while (temp->left != nullptr) {
-                //set temp node to left node
-                temp = temp->left;
-            }
-            //set bid node equal to temp bid
-            node->bid = temp->bid;
-            //remove right node
-            node->right = removeNode(node->right, temp->bid.bidId);
+        *minLink = min->right;
+        min->left = target->left;
+        min->right = target->right;
+        min->size = target->size - 1;
+        *link = min;
+
+        // min and the nodes it was detached from need rebalancing
+        // too; the first of those links lived in the removed node
+        path.push_back(link);
+        if (!minPath.empty()) {
+            minPath[0] = &min->right;
         }
+        path.insert(path.end(), minPath.begin(), minPath.end());
     }
+    nodePool.Destroy(target);
+    removed = true;
 
+    if (balanced) {
+        rebalancePath(path);
+    }
     return node;
+}
 
+/**
+ * Rebalance the node behind each link, deepest link first
+ *
+ * @param path Links from the top of the tree downwards
+ */
+void BinarySearchTree::rebalancePath(vector<Node**>& path) {
+    for (auto link = path.rbegin(); link != path.rend(); ++link) {
+        **link = rebalance(**link);
+    }
 }
 
+/**
+ * Height of a subtree in a balanced tree, 0 when empty
+ */
+int BinarySearchTree::height(Node* node) {
+    return node == nullptr ? 0 : node->height;
+}
 
+/**
+ * Number of bids in a subtree, 0 when empty
+ */
+int BinarySearchTree::size(Node* node) {
+    return node == nullptr ? 0 : node->size;
+}
 
-//============================================================================
-// Static methods used for testing
-//============================================================================
+/**
+ * Recompute a node's height and size from its children
+ */
+void BinarySearchTree::updateNode(Node* node) {
+    node->height = 1 + max(height(node->left), height(node->right));
+    node->size = 1 + size(node->left) + size(node->right);
+}
 
 /**
- * Display the bid information to the console (std::out)
+ * Rotate a subtree left, lifting its right child
  *
- * @param bid struct containing the bid info
+ * @return the new root of the subtree
  */
-void displayBid(Bid bid) {
-    cout << bid.bidId << ": " << bid.title << " | " << bid.amount << " | "
-            << bid.fund << endl;
-    return;
+Node* BinarySearchTree::rotateLeft(Node* node) {
+    Node* right = node->right;
+    node->right = right->left;
+    right->left = node;
+    updateNode(node);
+    updateNode(right);
+    return right;
 }
 
 /**
- * Load a CSV file containing bids into a container
+ * Rotate a subtree right, lifting its left child
  *
- * @param csvPath the path to the CSV file to load
- * @return a container holding all the bids read
+ * @return the new root of the subtree
  */
-void loadBids(string csvPath, BinarySearchTree* bst) {
-    cout << "Loading CSV file " << csvPath << endl;
+Node* BinarySearchTree::rotateRight(Node* node) {
+    Node* left = node->left;
+    node->left = left->right;
+    left->right = node;
+    updateNode(node);
+    updateNode(left);
+    return left;
+}
 
-    // initialize the CSV Parser using the given path
-    csv::Parser file = csv::Parser(csvPath);
+/**
+ * Restore the AVL property at a node whose subtrees differ in
+ * height by at most two, with one or two rotations
+ *
+ * @return the new root of the subtree
+ */
+Node* BinarySearchTree::rebalance(Node* node) {
+    updateNode(node);
+    int balance = height(node->left) - height(node->right);
+    // left heavy: a left-right shape first becomes left-left
+    if (balance > 1) {
+        if (height(node->left->left) < height(node->left->right)) {
+            node->left = rotateLeft(node->left);
+        }
+        return rotateRight(node);
+    }
+    // right heavy: a right-left shape first becomes right-right
+    if (balance < -1) {
+        if (height(node->right->right) < height(node->right->left)) {
+            node->right = rotateRight(node->right);
+        }
+        return rotateLeft(node);
+    }
+    return node;
+}
 
-    // read and display header row - optional
-    vector<string> header = file.getHeader();
-    for (auto const& c : header) {
-        cout << c << " | ";
+/**
+ * Link nodes already in order into a perfectly balanced subtree.
+ * A run of equal ids is rooted at its first node, with the later
+ * copies below it to the right, so a search still finds the first.
+ *
+ * @param nodes The nodes in order
+ * @param first Index of the first node of the subtree
+ * @param last One past the index of its last node
+ * @return the root of the subtree
+ */
+Node* BinarySearchTree::buildBalanced(vector<Node*>& nodes, size_t first, size_t last) {
+    if (first == last) {
+        return nullptr;
     }
-    cout << "" << endl;
+    size_t middle = first + (last - first) / 2;
+    while (middle > first && nodes[middle - 1]->bid.bidId == nodes[middle]->bid.bidId) {
+        middle--;
+    }
+    Node* node = nodes[middle];
+    node->left = buildBalanced(nodes, first, middle);
+    node->right = buildBalanced(nodes, middle + 1, last);
+    updateNode(node);
+    return node;
+}
 
-    try {
-        // loop to read rows of a CSV file
-        for (unsigned int i = 0; i < file.rowCount(); i++) {
+/**
+ * Add many bids at once. The bids are sorted by id unless they
+ * already are, merged with the bids in the tree, and moved into
+ * nodes taken from the pool in order, which are linked into a
+ * perfectly balanced tree in linear time, so the whole load
+ * costs about one sort rather than a descent per bid.
+ *
+ * Bids with equal ids keep their order, after any already in
+ * the tree, and the first of them sits above the rest, so Search
+ * returns the same copy as after inserting them one at a time into
+ * the plain tree. A long run of equal ids hangs as a right-leaning
+ * chain, as it does after plain inserts.
+ *
+ * @param bids The bids to add, in any order
+ */
+void BinarySearchTree::BulkLoad(vector<Bid> bids) {
+    auto byId = [](const Bid& a, const Bid& b) {
+        return a.bidId < b.bidId;
+    };
+    if (!is_sorted(bids.begin(), bids.end(), byId)) {
+        stable_sort(bids.begin(), bids.end(), byId);
+    }
+    if (frozen) {
+        thaw();
+    }
 
-            // Create a data structure and add to the collection of bids
-            Bid bid;
-            bid.bidId = file[i][1];
-            bid.title = file[i][0];
-            bid.fund = file[i][8];
-            bid.amount = strToDouble(file[i][4], '$');
+    if (root != nullptr) {
+        // take the current bids out in order, freeing their nodes
+        vector<Bid> current;
+        vector<Node*> stack;
+        Node* node = root;
+        while (node != nullptr || !stack.empty()) {
+            while (node != nullptr) {
+                stack.push_back(node);
+                node = node->left;
+            }
+            node = stack.back();
+            stack.pop_back();
+            current.push_back(move(node->bid));
+            Node* right = node->right;
+            nodePool.Destroy(node);
+            node = right;
+        }
 
-            //cout << "Item: " << bid.title << ", Fund: " << bid.fund << ", Amount: " << bid.amount << endl;
+        vector<Bid> merged;
+        merged.reserve(current.size() + bids.size());
+        merge(make_move_iterator(current.begin()), make_move_iterator(current.end()),
+              make_move_iterator(bids.begin()), make_move_iterator(bids.end()),
+              back_inserter(merged), byId);
+        bids.swap(merged);
+    }
+    vector<Node*> nodes;
+    nodes.reserve(bids.size());
+    for (auto& bid : bids) {
+        nodes.push_back(nodePool.Create(move(bid)));
+    }
+    root = buildBalanced(nodes, 0, nodes.size());
+    if (filtered) {
+        rebuildBloom();
+    }
+}
 
-            // push this bid to the end
-            bst->Insert(bid);
+/**
+ * Turn AVL balancing on or off. Turning it on relinks the
+ * current nodes into a perfectly balanced tree first.
+ *
+ * @param enabled true to keep the tree balanced from now on
+ */
+void BinarySearchTree::SetBalanced(bool enabled) {
+    if (enabled && !balanced) {
+        // collect the nodes in order with an explicit stack
+        vector<Node*> nodes;
+        vector<Node*> stack;
+        Node* node = root;
+        while (node != nullptr || !stack.empty()) {
+            while (node != nullptr) {
+                stack.push_back(node);
+                node = node->left;
+            }
+            node = stack.back();
+            stack.pop_back();
+            nodes.push_back(node);
+            node = node->right;
         }
-    } catch (csv::Error &e) {
-        std::cerr << e.what() << std::endl;
+        root = buildBalanced(nodes, 0, nodes.size());
     }
+    if (enabled) {
+        splayed = false;
+    }
+    balanced = enabled;
 }
 
 /**
- * Simple C function to convert a string to a double
- * after stripping out unwanted char
+ * Top-down splay: walk down from a node towards a bid id,
+ * rotating pairs of nodes on the way and hanging what is passed
+ * on a left tree of smaller ids and a right tree of larger ones,
+ * then reassemble the three with the last node reached as the
+ * root. The path to that node ends up about half as deep, so
+ * repeated searches for a few ids find them near the top. The
+ * walk is a single loop, and subtree sizes are repaired along
+ * the two spines afterwards so Rank and Select stay correct.
  *
- * credit: http://stackoverflow.com/a/24875936
+ * @param node Root of the tree to splay
+ * @param bidId The bid id to bring to the root, or the last
+ *              node on its search path when it is missing
+ * @return the new root
+ */
+Node* BinarySearchTree::splay(Node* node, const string& bidId) {
+    if (node == nullptr) {
+        return node;
+    }
+    // header.right collects the left tree, header.left the right tree
+    Node header;
+    Node* leftMax = &header;
+    Node* rightMin = &header;
+    int leftSize = 0;
+    int rightSize = 0;
+
+    for (;;) {
+        scanStats.nodes++;
+        int order = bidId.compare(node->bid.bidId);
+        if (order < 0) {
+            if (node->left == nullptr) {
+                break;
+            }
+            // zig-zig: rotate right before linking
+            if (bidId.compare(node->left->bid.bidId) < 0) {
+                scanStats.nodes++;
+                Node* child = node->left;
+                node->left = child->right;
+                child->right = node;
+                node->size = 1 + size(node->left) + size(node->right);
+                node = child;
+                if (node->left == nullptr) {
+                    break;
+                }
+            }
+            // link the node into the right tree
+            rightMin->left = node;
+            rightMin = node;
+            node = node->left;
+            rightSize += 1 + size(rightMin->right);
+        }
+        else if (order > 0) {
+            if (node->right == nullptr) {
+                break;
+            }
+            // zag-zag: rotate left before linking
+            if (bidId.compare(node->right->bid.bidId) > 0) {
+                scanStats.nodes++;
+                Node* child = node->right;
+                node->right = child->left;
+                child->left = node;
+                node->size = 1 + size(node->left) + size(node->right);
+                node = child;
+                if (node->right == nullptr) {
+                    break;
+                }
+            }
+            // link the node into the left tree
+            leftMax->right = node;
+            leftMax = node;
+            node = node->right;
+            leftSize += 1 + size(leftMax->left);
+        }
+        else {
+            break;
+        }
+    }
+
+    leftSize += size(node->left);
+    rightSize += size(node->right);
+    node->size = leftSize + rightSize + 1;
+    leftMax->right = nullptr;
+    rightMin->left = nullptr;
+
+    // the nodes down the right spine of the left tree, and down the
+    // left spine of the right tree, each lose what lies below them
+    for (Node* spine = header.right; spine != nullptr; spine = spine->right) {
+        spine->size = leftSize;
+        leftSize -= 1 + size(spine->left);
+    }
+    for (Node* spine = header.left; spine != nullptr; spine = spine->left) {
+        spine->size = rightSize;
+        rightSize -= 1 + size(spine->right);
+    }
+
+    leftMax->right = node->left;
+    rightMin->left = node->right;
+    node->left = header.right;
+    node->right = header.left;
+    return node;
+}
+
+/**
+ * Turn splaying on or off. While on, every Search moves the node
+ * it finds to the root, which also means a search changes the
+ * tree and invalidates iterators. Splaying and AVL balancing
+ * exclude each other, so turning one on turns the other off.
  *
- * @param ch The character to strip out
+ * @param enabled true to splay on every search from now on
  */
-double strToDouble(string str, char ch) {
-    str.erase(remove(str.begin(), str.end(), ch), str.end());
-    return atof(str.c_str());
+void BinarySearchTree::SetSplay(bool enabled) {
+    if (enabled) {
+        balanced = false;
+    }
+    splayed = enabled;
 }
 
 /**
- * The one and only main() method
+ * Returns how many searches walked the tree and how many nodes
+ * they visited
  */
-int main(int argc, char* argv[]) {
+ScanStats BinarySearchTree::SearchStats() {
+    return scanStats;
+}
+
+/**
+ * Returns the number of levels in the tree, counted level by
+ * level so it works on any tree, balanced or not
+ */
+int BinarySearchTree::Height() {
+    int levels = 0;
+    vector<Node*> level;
+    vector<Node*> next;
+    if (root != nullptr) {
+        level.push_back(root);
+    }
+    while (!level.empty()) {
+        levels++;
+        next.clear();
+        for (Node* node : level) {
+            if (node->left != nullptr) {
+                next.push_back(node->left);
+            }
+            if (node->right != nullptr) {
+                next.push_back(node->right);
+            }
+        }
+        level.swap(next);
+    }
+    return levels;
+}
+
+/**
+ * Returns the number of bids in the tree
+ */
+int BinarySearchTree::Size() {
+    return size(root);
+}
+
+/**
+ * Count the bids with an id below a bid id, or up to it when
+ * inclusive, adding up left subtree sizes along one descent
+ */
+int BinarySearchTree::countBelow(const string& bidId, bool inclusive) {
+    int count = 0;
+    Node* node = root;
+    while (node != nullptr) {
+        int order = node->bid.bidId.compare(bidId);
+        if (order < 0 || (inclusive && order == 0)) {
+            // this node and its whole left subtree come before
+            count += size(node->left) + 1;
+            node = node->right;
+        }
+        else {
+            node = node->left;
+        }
+    }
+    return count;
+}
+
+/**
+ * Returns the number of bids whose id is less than a bid id,
+ * which is also the position the id has or would have in order
+ */
+int BinarySearchTree::Rank(string bidId) {
+    return countBelow(bidId, false);
+}
+
+/**
+ * Returns the bid at a position in bid id order, counting from
+ * 0, or an empty bid when there is no such position
+ *
+ * @param k Number of bids before the one wanted
+ */
+Bid BinarySearchTree::Select(int k) {
+    Node* node = root;
+    while (node != nullptr) {
+        int left = size(node->left);
+        if (k < left) {
+            node = node->left;
+        }
+        else if (k == left) {
+            return node->bid;
+        }
+        else {
+            // skip this node and everything left of it
+            k -= left + 1;
+            node = node->right;
+        }
+    }
+    return Bid();
+}
+
+/**
+ * Returns the number of bids whose id lies within a range
+ *
+ * @param lo Lowest bid id to include
+ * @param hi Highest bid id to include
+ */
+int BinarySearchTree::CountInRange(string lo, string hi) {
+    if (hi < lo) {
+        return 0;
+    }
+    return countBelow(hi, true) - countBelow(lo, false);
+}
+
+/**
+ * Pack the first eight characters of a bid id into an integer
+ * that orders the same way the ids do
+ */
+uint64_t BinarySearchTree::packKey(const string& bidId) {
+    uint64_t key = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        key <<= 8;
+        if (i < bidId.size()) {
+            key |= (unsigned char)bidId[i];
+        }
+    }
+    return key;
+}
+
+/**
+ * Copy sorted bids into the frozen arrays by walking the
+ * implicit tree in order
+ *
+ * @param sorted The bids in order
+ * @param next Index of the next bid to place
+ * @param k Position of the subtree's root in the arrays
+ */
+void BinarySearchTree::fillFrozen(vector<Bid>& sorted, size_t& next, size_t k) {
+    if (k > frozenCount) {
+        return;
+    }
+    fillFrozen(sorted, next, 2 * k);
+    frozenKeys[k] = packKey(sorted[next].bidId);
+    frozenBids[k] = move(sorted[next]);
+    next++;
+    fillFrozen(sorted, next, 2 * k + 1);
+}
+
+/**
+ * Search the frozen arrays. The descent has no branches to
+ * mispredict: each step picks the child from a comparison and
+ * prefetches the cache line holding the node's eight
+ * great-grandchildren, so the lines needed three levels down
+ * are already on their way.
+ */
+Bid BinarySearchTree::searchFrozen(const string& bidId) {
+    uint64_t key = packKey(bidId);
+    uintptr_t base = reinterpret_cast<uintptr_t>(frozenKeys);
+    size_t k = 1;
+    while (k <= frozenCount) {
+        // a prefetch past the end of the array is simply dropped
+        _mm_prefetch(reinterpret_cast<const char*>(base + k * 8 * sizeof(uint64_t)), _MM_HINT_T0);
+        k = 2 * k + (frozenKeys[k] < key);
+    }
+    // undo the right turns taken since the last left turn, and
+    // that left turn, to land on the first key not less than ours
+    while (k & 1) {
+        k >>= 1;
+    }
+    k >>= 1;
+
+    // ids longer than eight characters can share a packed key
+    while (k != 0 && frozenKeys[k] == key) {
+        int order = frozenBids[k].bidId.compare(bidId);
+        if (order == 0) {
+            return frozenBids[k];
+        }
+        if (order > 0) {
+            break;
+        }
+        // step to the next key in order
+        if (2 * k + 1 <= frozenCount) {
+            k = 2 * k + 1;
+            while (2 * k <= frozenCount) {
+                k = 2 * k;
+            }
+        }
+        else {
+            while (k & 1) {
+                k >>= 1;
+            }
+            k >>= 1;
+        }
+    }
+    return Bid();
+}
+
+/**
+ * Drop the frozen arrays before the tree changes
+ */
+void BinarySearchTree::thaw() {
+    frozen = false;
+    frozenCount = 0;
+    frozenKeys = nullptr;
+    vector<uint64_t>().swap(frozenWords);
+    vector<Bid>().swap(frozenBids);
+}
+
+/**
+ * Copy the tree into a read-only search structure. The keys go
+ * into one array in Eytzinger order, the order of a breadth
+ * first walk of a perfectly balanced tree, so the children of
+ * position k sit at 2k and 2k + 1 and no pointers are needed.
+ * The bids go into a parallel array. Search then uses these
+ * arrays until the next Insert, Remove or BulkLoad, which
+ * drop them again; the nodes are kept for everything else.
+ */
+void BinarySearchTree::Freeze() {
+    thaw();
+    vector<Bid> sorted(begin(), end());
+    frozenCount = sorted.size();
+
+    // over-allocate one cache line so the keys start on a line
+    // boundary and every group of eight children shares a line
+    frozenWords.assign(frozenCount + 1 + 8, 0);
+    uintptr_t start = reinterpret_cast<uintptr_t>(frozenWords.data());
+    frozenKeys = frozenWords.data() + ((64 - start % 64) % 64) / sizeof(uint64_t);
+    frozenBids.resize(frozenCount + 1);
+
+    size_t next = 0;
+    fillFrozen(sorted, next, 1);
+    frozen = true;
+}
+
+/**
+ * Returns true while Search uses the frozen arrays
+ */
+bool BinarySearchTree::Frozen() {
+    return frozen;
+}
+
+/**
+ * Refill the Bloom filter from every node in the tree, using an
+ * explicit stack so a degenerate tree cannot overflow the call stack
+ */
+void BinarySearchTree::rebuildBloom() {
+    vector<Node*> stack;
+    vector<string> bidIds;
+    if (root != nullptr) {
+        stack.push_back(root);
+    }
+    while (!stack.empty()) {
+        Node* node = stack.back();
+        stack.pop_back();
+        bidIds.push_back(node->bid.bidId);
+        if (node->left != nullptr) {
+            stack.push_back(node->left);
+        }
+        if (node->right != nullptr) {
+            stack.push_back(node->right);
+        }
+    }
+
+    // size for twice the current number of bids
+    bloom.Clear(bidIds.size() * 2);
+    for (auto const& bidId : bidIds) {
+        bloom.Add(bidId);
+    }
+}
+
+/**
+ * Turn the Bloom filter in front of Search and Remove on or off
+ *
+ * @param enabled true to build the filter over the current tree
+ */
+void BinarySearchTree::SetBloomFilter(bool enabled) {
+    if (enabled && !filtered) {
+        rebuildBloom();
+    }
+    filtered = enabled;
+}
+
+/**
+ * Returns the size and hit statistics of the Bloom filter
+ */
+BloomFilterStats BinarySearchTree::BloomStats() {
+    return bloom.Stats();
+}
+
+/**
+ * Returns the allocation statistics of the tree's node pool
+ */
+NodePoolStats BinarySearchTree::PoolStats() {
+    return nodePool.Stats();
+}
+
+//============================================================================
+// B+ Tree class definition
+//============================================================================
+
+/**
+ * Define a class containing data members and methods to
+ * implement a B+ tree keyed on bid id. Each node holds up to
+ * MAX_KEYS keys in one contiguous array, so a lookup reads a
+ * few wide nodes instead of taking a cache miss per level as
+ * the binary tree does. Bids live only in the leaves, which
+ * are linked left to right for ordered output.
+ *
+ * Every node but the root holds at least MIN_KEYS keys. A key
+ * inserted next to equal keys goes after them, and Search and
+ * Remove find the first of them.
+ */
+class BPlusTree {
+
+private:
+    static const int MAX_KEYS = 32;
+    static const int MIN_KEYS = MAX_KEYS / 2;
+
+    // the keys are shared by both kinds of node; each array has
+    // one spare slot so a node can overflow before it splits
+    struct BNode {
+        bool leaf;
+        int count;
+        string keys[MAX_KEYS + 1];
+
+        BNode(bool isLeaf) : leaf(isLeaf), count(0) {
+        }
+    };
+
+    // a leaf holds the bid for each key
+    struct Leaf : BNode {
+        Leaf* next;
+        Bid bids[MAX_KEYS + 1];
+
+        Leaf() : BNode(true), next(nullptr) {
+        }
+    };
+
+    // an inner node holds count + 1 children; child i holds the
+    // keys between keys[i - 1] and keys[i]
+    struct Inner : BNode {
+        BNode* children[MAX_KEYS + 2];
+
+        Inner() : BNode(false) {
+        }
+    };
+
+    BNode* root;
+    int size = 0;
+
+    static void destroy(BNode* node);
+    static int lowerBound(BNode* node, const string& key);
+    static int upperBound(BNode* node, const string& key);
+    BNode* insertInto(BNode* node, const Bid& bid, string& separator);
+    bool removeFrom(BNode* node, const string& bidId);
+    void fixChild(Inner* parent, int index);
+    void merge(Inner* parent, int index);
+    Leaf* firstLeaf();
+
+public:
+    BPlusTree();
+    virtual ~BPlusTree();
+    BPlusTree(const BPlusTree&) = delete;
+    BPlusTree& operator=(const BPlusTree&) = delete;
+    void InOrder();
+    void InOrder(BufferedWriter& out);
+    void Insert(Bid bid);
+    void Remove(string bidId);
+    Bid Search(string bidId);
+    int Size();
+    int Height();
+};
+
+/**
+ * Default constructor
+ */
+BPlusTree::BPlusTree() {
+    root = nullptr;
+}
+
+/**
+ * Destructor
+ */
+BPlusTree::~BPlusTree() {
+    // delete every node, keeping the ones still to visit on a stack
+    vector<BNode*> stack;
+    if (root != nullptr) {
+        stack.push_back(root);
+    }
+    while (!stack.empty()) {
+        BNode* node = stack.back();
+        stack.pop_back();
+        if (!node->leaf) {
+            Inner* inner = static_cast<Inner*>(node);
+            for (int i = 0; i <= inner->count; ++i) {
+                stack.push_back(inner->children[i]);
+            }
+        }
+        destroy(node);
+    }
+}
+
+/**
+ * Delete a node as the kind of node it is
+ */
+void BPlusTree::destroy(BNode* node) {
+    if (node->leaf) {
+        delete static_cast<Leaf*>(node);
+    }
+    else {
+        delete static_cast<Inner*>(node);
+    }
+}
+
+/**
+ * Position of the first key in a node not less than a key
+ */
+int BPlusTree::lowerBound(BNode* node, const string& key) {
+    return (int)(lower_bound(node->keys, node->keys + node->count, key) - node->keys);
+}
+
+/**
+ * Position of the first key in a node greater than a key
+ */
+int BPlusTree::upperBound(BNode* node, const string& key) {
+    return (int)(upper_bound(node->keys, node->keys + node->count, key) - node->keys);
+}
+
+/**
+ * Returns the leftmost leaf, or nullptr for an empty tree
+ */
+BPlusTree::Leaf* BPlusTree::firstLeaf() {
+    BNode* node = root;
+    while (node != nullptr && !node->leaf) {
+        node = static_cast<Inner*>(node)->children[0];
+    }
+    return static_cast<Leaf*>(node);
+}
+
+/**
+ * Traverse the tree in order
+ */
+void BPlusTree::InOrder() {
+    BufferedWriter out;
+    InOrder(out);
+}
+
+/**
+ * Traverse the tree in order along the leaf links, writing to
+ * a buffered writer
+ *
+ * @param out The writer for standard output, a pipe or a file
+ */
+void BPlusTree::InOrder(BufferedWriter& out) {
+    for (Leaf* leaf = firstLeaf(); leaf != nullptr; leaf = leaf->next) {
+        for (int i = 0; i < leaf->count; ++i) {
+            out << leaf->bids[i].bidId << ": "
+                << leaf->bids[i].title << " | "
+                << leaf->bids[i].amount << " | "
+                << leaf->bids[i].fund << '\n';
+        }
+    }
+}
+
+/**
+ * Insert a bid into a subtree (recursive, to the tree's height)
+ *
+ * @param node Root of the subtree
+ * @param bid Bid to be added
+ * @param separator Receives the first key of the new node on a split
+ * @return the new right sibling when node split, else nullptr
+ */
+BPlusTree::BNode* BPlusTree::insertInto(BNode* node, const Bid& bid, string& separator) {
+    if (node->leaf) {
+        Leaf* leaf = static_cast<Leaf*>(node);
+        int pos = upperBound(leaf, bid.bidId);
+        for (int i = leaf->count; i > pos; --i) {
+            leaf->keys[i] = move(leaf->keys[i - 1]);
+            leaf->bids[i] = move(leaf->bids[i - 1]);
+        }
+        leaf->keys[pos] = bid.bidId;
+        leaf->bids[pos] = bid;
+        leaf->count++;
+        if (leaf->count <= MAX_KEYS) {
+            return nullptr;
+        }
+
+        // split off the upper half into a new leaf on the right
+        Leaf* right = new Leaf();
+        int half = leaf->count / 2;
+        for (int i = half; i < leaf->count; ++i) {
+            right->keys[i - half] = move(leaf->keys[i]);
+            right->bids[i - half] = move(leaf->bids[i]);
+        }
+        right->count = leaf->count - half;
+        leaf->count = half;
+        right->next = leaf->next;
+        leaf->next = right;
+        separator = right->keys[0];
+        return right;
+    }
+
+    Inner* inner = static_cast<Inner*>(node);
+    int index = upperBound(inner, bid.bidId);
+    string childSeparator;
+    BNode* added = insertInto(inner->children[index], bid, childSeparator);
+    if (added == nullptr) {
+        return nullptr;
+    }
+    for (int i = inner->count; i > index; --i) {
+        inner->keys[i] = move(inner->keys[i - 1]);
+        inner->children[i + 1] = inner->children[i];
+    }
+    inner->keys[index] = move(childSeparator);
+    inner->children[index + 1] = added;
+    inner->count++;
+    if (inner->count <= MAX_KEYS) {
+        return nullptr;
+    }
+
+    // split around the middle key, which moves up to the parent
+    Inner* right = new Inner();
+    int middle = inner->count / 2;
+    for (int i = middle + 1; i < inner->count; ++i) {
+        right->keys[i - middle - 1] = move(inner->keys[i]);
+    }
+    for (int i = middle + 1; i <= inner->count; ++i) {
+        right->children[i - middle - 1] = inner->children[i];
+    }
+    right->count = inner->count - middle - 1;
+    separator = move(inner->keys[middle]);
+    inner->count = middle;
+    return right;
+}
+
+/**
+ * Insert a bid
+ */
+void BPlusTree::Insert(Bid bid) {
+    if (root == nullptr) {
+        root = new Leaf();
+    }
+    string separator;
+    BNode* added = insertInto(root, bid, separator);
+    // a split root gets a new root above it
+    if (added != nullptr) {
+        Inner* top = new Inner();
+        top->keys[0] = move(separator);
+        top->children[0] = root;
+        top->children[1] = added;
+        top->count = 1;
+        root = top;
+    }
+    size++;
+}
+
+/**
+ * Move the keys of the child right of index into the child at
+ * index and drop the right child
+ */
+void BPlusTree::merge(Inner* parent, int index) {
+    BNode* left = parent->children[index];
+    BNode* right = parent->children[index + 1];
+    if (left->leaf) {
+        Leaf* to = static_cast<Leaf*>(left);
+        Leaf* from = static_cast<Leaf*>(right);
+        for (int i = 0; i < from->count; ++i) {
+            to->keys[to->count + i] = move(from->keys[i]);
+            to->bids[to->count + i] = move(from->bids[i]);
+        }
+        to->count += from->count;
+        to->next = from->next;
+    }
+    else {
+        // the separator comes down between the two halves
+        Inner* to = static_cast<Inner*>(left);
+        Inner* from = static_cast<Inner*>(right);
+        to->keys[to->count] = move(parent->keys[index]);
+        for (int i = 0; i < from->count; ++i) {
+            to->keys[to->count + 1 + i] = move(from->keys[i]);
+        }
+        for (int i = 0; i <= from->count; ++i) {
+            to->children[to->count + 1 + i] = from->children[i];
+        }
+        to->count += from->count + 1;
+    }
+    destroy(right);
+
+    for (int i = index; i < parent->count - 1; ++i) {
+        parent->keys[i] = move(parent->keys[i + 1]);
+        parent->children[i + 1] = parent->children[i + 2];
+    }
+    parent->count--;
+}
+
+/**
+ * Refill a child left with too few keys, borrowing one from a
+ * sibling that can spare it or else merging with a sibling
+ *
+ * @param parent The child's parent
+ * @param index The child's position in the parent
+ */
+void BPlusTree::fixChild(Inner* parent, int index) {
+    BNode* child = parent->children[index];
+    BNode* left = index > 0 ? parent->children[index - 1] : nullptr;
+    BNode* right = index < parent->count ? parent->children[index + 1] : nullptr;
+
+    // borrow the last key of the left sibling
+    if (left != nullptr && left->count > MIN_KEYS) {
+        for (int i = child->count; i > 0; --i) {
+            child->keys[i] = move(child->keys[i - 1]);
+        }
+        if (child->leaf) {
+            Leaf* to = static_cast<Leaf*>(child);
+            Leaf* from = static_cast<Leaf*>(left);
+            for (int i = to->count; i > 0; --i) {
+                to->bids[i] = move(to->bids[i - 1]);
+            }
+            to->keys[0] = move(from->keys[from->count - 1]);
+            to->bids[0] = move(from->bids[from->count - 1]);
+            parent->keys[index - 1] = to->keys[0];
+        }
+        else {
+            Inner* to = static_cast<Inner*>(child);
+            Inner* from = static_cast<Inner*>(left);
+            for (int i = to->count + 1; i > 0; --i) {
+                to->children[i] = to->children[i - 1];
+            }
+            to->keys[0] = move(parent->keys[index - 1]);
+            to->children[0] = from->children[from->count];
+            parent->keys[index - 1] = move(from->keys[from->count - 1]);
+        }
+        left->count--;
+        child->count++;
+    }
+    // borrow the first key of the right sibling
+    else if (right != nullptr && right->count > MIN_KEYS) {
+        if (child->leaf) {
+            Leaf* to = static_cast<Leaf*>(child);
+            Leaf* from = static_cast<Leaf*>(right);
+            to->keys[to->count] = move(from->keys[0]);
+            to->bids[to->count] = move(from->bids[0]);
+            for (int i = 0; i < from->count - 1; ++i) {
+                from->keys[i] = move(from->keys[i + 1]);
+                from->bids[i] = move(from->bids[i + 1]);
+            }
+            parent->keys[index] = from->keys[0];
+        }
+        else {
+            Inner* to = static_cast<Inner*>(child);
+            Inner* from = static_cast<Inner*>(right);
+            to->keys[to->count] = move(parent->keys[index]);
+            to->children[to->count + 1] = from->children[0];
+            parent->keys[index] = move(from->keys[0]);
+            for (int i = 0; i < from->count - 1; ++i) {
+                from->keys[i] = move(from->keys[i + 1]);
+            }
+            for (int i = 0; i < from->count; ++i) {
+                from->children[i] = from->children[i + 1];
+            }
+        }
+        right->count--;
+        child->count++;
+    }
+    // else neither sibling can spare a key, so two nodes become one
+    else if (left != nullptr) {
+        merge(parent, index - 1);
+    }
+    else {
+        merge(parent, index);
+    }
+}
+
+/**
+ * Remove the first bid with a bid id from a subtree (recursive,
+ * to the tree's height)
+ *
+ * @return true when a bid was removed
+ */
+bool BPlusTree::removeFrom(BNode* node, const string& bidId) {
+    if (node->leaf) {
+        Leaf* leaf = static_cast<Leaf*>(node);
+        int pos = lowerBound(leaf, bidId);
+        if (pos == leaf->count || leaf->keys[pos] != bidId) {
+            return false;
+        }
+        for (int i = pos; i < leaf->count - 1; ++i) {
+            leaf->keys[i] = move(leaf->keys[i + 1]);
+            leaf->bids[i] = move(leaf->bids[i + 1]);
+        }
+        leaf->count--;
+        leaf->keys[leaf->count] = string();
+        leaf->bids[leaf->count] = Bid();
+        return true;
+    }
+
+    // equal keys may straddle several children, so try each in turn
+    Inner* inner = static_cast<Inner*>(node);
+    int last = upperBound(inner, bidId);
+    for (int i = lowerBound(inner, bidId); i <= last; ++i) {
+        if (removeFrom(inner->children[i], bidId)) {
+            if (inner->children[i]->count < MIN_KEYS) {
+                fixChild(inner, i);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Remove a bid
+ */
+void BPlusTree::Remove(string bidId) {
+    if (root == nullptr || !removeFrom(root, bidId)) {
+        return;
+    }
+    size--;
+    // a root left with a single child hands over to it
+    if (!root->leaf && root->count == 0) {
+        BNode* old = root;
+        root = static_cast<Inner*>(root)->children[0];
+        destroy(old);
+    }
+}
+
+/**
+ * Search for a bid
+ */
+Bid BPlusTree::Search(string bidId) {
+    BNode* node = root;
+    if (node == nullptr) {
+        return Bid();
+    }
+    // descend towards the first key not less than the bid id
+    while (!node->leaf) {
+        node = static_cast<Inner*>(node)->children[lowerBound(node, bidId)];
+    }
+    Leaf* leaf = static_cast<Leaf*>(node);
+    int pos = lowerBound(leaf, bidId);
+    // that key may be the first of the next leaf
+    if (pos == leaf->count) {
+        leaf = leaf->next;
+        pos = 0;
+    }
+    if (leaf != nullptr && pos < leaf->count && leaf->keys[pos] == bidId) {
+        return leaf->bids[pos];
+    }
+    return Bid();
+}
+
+/**
+ * Returns the number of bids in the tree
+ */
+int BPlusTree::Size() {
+    return size;
+}
+
+/**
+ * Returns the number of levels in the tree
+ */
+int BPlusTree::Height() {
+    int levels = 0;
+    for (BNode* node = root; node != nullptr;
+         node = node->leaf ? nullptr : static_cast<Inner*>(node)->children[0]) {
+        levels++;
+    }
+    return levels;
+}
+
+//============================================================================
+// Persistent Binary Search Tree class definition
+//============================================================================
+
+/**
+ * Define a class containing data members and methods to
+ * implement a persistent binary search tree, which readers can
+ * keep searching while a writer changes it.
+ *
+ * Nodes never change once built. A writer copies only the path
+ * from the root to the node it changes, shares every other
+ * subtree with the previous version, and publishes the new root
+ * in one atomic store. A reader takes a snapshot, which holds
+ * one version's root, and searches it without locks for as long
+ * as it likes, always seeing that point in time. Taking the
+ * snapshot itself is not lock-free: the atomic shared_ptr
+ * functions guard each pointer with a short internal lock, held
+ * only to copy the root and bump its count. Nodes are
+ * reference counted, so a version's nodes are freed as soon as
+ * no snapshot or newer version uses them.
+ *
+ * The tree is kept AVL balanced, so a path copy is O(log n)
+ * nodes, and freeing a version never recurses deeper than that.
+ */
+class PersistentBinarySearchTree {
+
+private:
+    struct PNode;
+    typedef shared_ptr<const PNode> Link;
+
+    struct PNode {
+        Bid bid;
+        Link left;
+        Link right;
+        int height;
+        int size;
+
+        PNode(const Bid& aBid, const Link& aLeft, const Link& aRight);
+        ~PNode();
+    };
+
+    // the current version; read and replaced only atomically
+    Link root;
+
+    // writers take turns; readers never take this lock
+    mutex writer;
+
+    static atomic<size_t> liveNodes;
+
+    static int height(const Link& node);
+    static int size(const Link& node);
+    static Link balance(const Bid& bid, const Link& left, const Link& right);
+    static Link insert(const Link& node, const Bid& bid);
+    static Link remove(const Link& node, const string& bidId, bool& removed);
+    static Link removeMin(const Link& node, Bid& min);
+    static Link build(vector<Bid>& bids, size_t first, size_t last);
+    void publish(const Link& version);
+
+public:
+    /**
+     * An immutable, point-in-time view of the tree
+     */
+    class Snapshot {
+    public:
+        Bid Search(string bidId) const;
+        void InOrder(BufferedWriter& out) const;
+        int Size() const;
+
+    private:
+        friend class PersistentBinarySearchTree;
+
+        Link root;
+
+        Snapshot(const Link& root) : root(root) {
+        }
+    };
+
+    PersistentBinarySearchTree();
+    PersistentBinarySearchTree(const PersistentBinarySearchTree&) = delete;
+    PersistentBinarySearchTree& operator=(const PersistentBinarySearchTree&) = delete;
+    Snapshot GetSnapshot() const;
+    void Insert(Bid bid);
+    void Remove(string bidId);
+    void RemoveAll(const vector<string>& bidIds);
+    void BulkLoad(vector<Bid> bids);
+    Bid Search(string bidId) const;
+    static size_t LiveNodes();
+};
+
+atomic<size_t> PersistentBinarySearchTree::liveNodes(0);
+
+/**
+ * Build a node over two subtrees, taking its height and size
+ * from them
+ */
+PersistentBinarySearchTree::PNode::PNode(const Bid& aBid, const Link& aLeft, const Link& aRight) :
+        bid(aBid), left(aLeft), right(aRight) {
+    height = 1 + max(PersistentBinarySearchTree::height(left), PersistentBinarySearchTree::height(right));
+    size = 1 + PersistentBinarySearchTree::size(left) + PersistentBinarySearchTree::size(right);
+    liveNodes++;
+}
+
+PersistentBinarySearchTree::PNode::~PNode() {
+    liveNodes--;
+}
+
+/**
+ * Default constructor
+ */
+PersistentBinarySearchTree::PersistentBinarySearchTree() {
+}
+
+/**
+ * Height of a subtree, 0 when empty
+ */
+int PersistentBinarySearchTree::height(const Link& node) {
+    return node == nullptr ? 0 : node->height;
+}
+
+/**
+ * Number of bids in a subtree, 0 when empty
+ */
+int PersistentBinarySearchTree::size(const Link& node) {
+    return node == nullptr ? 0 : node->size;
+}
+
+/**
+ * Build a node over two subtrees whose heights differ by at
+ * most two, rotating as new nodes where they differ by two
+ *
+ * @return the root of the balanced subtree
+ */
+PersistentBinarySearchTree::Link PersistentBinarySearchTree::balance(const Bid& bid,
+        const Link& left, const Link& right) {
+    if (height(left) > height(right) + 1) {
+        // left-left lifts the left child, left-right its right child
+        if (height(left->left) >= height(left->right)) {
+            return make_shared<const PNode>(left->bid, left->left,
+                make_shared<const PNode>(bid, left->right, right));
+        }
+        return make_shared<const PNode>(left->right->bid,
+            make_shared<const PNode>(left->bid, left->left, left->right->left),
+            make_shared<const PNode>(bid, left->right->right, right));
+    }
+    if (height(right) > height(left) + 1) {
+        // right-right lifts the right child, right-left its left child
+        if (height(right->right) >= height(right->left)) {
+            return make_shared<const PNode>(right->bid,
+                make_shared<const PNode>(bid, left, right->left), right->right);
+        }
+        return make_shared<const PNode>(right->left->bid,
+            make_shared<const PNode>(bid, left, right->left->left),
+            make_shared<const PNode>(right->bid, right->left->right, right->right));
+    }
+    return make_shared<const PNode>(bid, left, right);
+}
+
+/**
+ * Returns a copy of a subtree with a bid added, sharing every
+ * node off the path to it (recursive, to the tree's height)
+ */
+PersistentBinarySearchTree::Link PersistentBinarySearchTree::insert(const Link& node, const Bid& bid) {
+    if (node == nullptr) {
+        return make_shared<const PNode>(bid, nullptr, nullptr);
+    }
+    // equal ids go right, as in the binary search tree
+    if (node->bid.bidId.compare(bid.bidId) > 0) {
+        return balance(node->bid, insert(node->left, bid), node->right);
+    }
+    return balance(node->bid, node->left, insert(node->right, bid));
+}
+
+/**
+ * Returns a copy of a subtree without its smallest bid
+ *
+ * @param min Receives the smallest bid
+ */
+PersistentBinarySearchTree::Link PersistentBinarySearchTree::removeMin(const Link& node, Bid& min) {
+    if (node->left == nullptr) {
+        min = node->bid;
+        return node->right;
+    }
+    Link left = removeMin(node->left, min);
+    return balance(node->bid, left, node->right);
+}
+
+/**
+ * Returns a copy of a subtree without the first node found
+ * holding a bid id, or the subtree itself when there is none
+ *
+ * @param removed Set to true when a bid was removed
+ */
+PersistentBinarySearchTree::Link PersistentBinarySearchTree::remove(const Link& node,
+        const string& bidId, bool& removed) {
+    if (node == nullptr) {
+        return node;
+    }
+    int order = bidId.compare(node->bid.bidId);
+    if (order < 0) {
+        Link left = remove(node->left, bidId, removed);
+        return removed ? balance(node->bid, left, node->right) : node;
+    }
+    if (order > 0) {
+        Link right = remove(node->right, bidId, removed);
+        return removed ? balance(node->bid, node->left, right) : node;
+    }
+
+    removed = true;
+    if (node->left == nullptr) {
+        return node->right;
+    }
+    if (node->right == nullptr) {
+        return node->left;
+    }
+    // the smallest bid on the right takes this node's place
+    Bid min;
+    Link right = removeMin(node->right, min);
+    return balance(min, node->left, right);
+}
+
+/**
+ * Build a perfectly balanced subtree from bids in order
+ *
+ * @param first Index of the first bid of the subtree
+ * @param last One past the index of its last bid
+ */
+PersistentBinarySearchTree::Link PersistentBinarySearchTree::build(vector<Bid>& bids,
+        size_t first, size_t last) {
+    if (first == last) {
+        return nullptr;
+    }
+    size_t middle = first + (last - first) / 2;
+    Link left = build(bids, first, middle);
+    Link right = build(bids, middle + 1, last);
+    return make_shared<const PNode>(bids[middle], left, right);
+}
+
+/**
+ * Make a version current. The previous version lives on in any
+ * snapshot still holding it. atomic_store on a shared_ptr takes
+ * the library's internal lock for the pointer, so a reader taking
+ * a snapshot at the same moment waits for the swap, never for a
+ * whole write. C++20 deprecates these functions in favour of
+ * atomic<shared_ptr>, which this C++14 code cannot use yet.
+ */
+void PersistentBinarySearchTree::publish(const Link& version) {
+    atomic_store(&root, version);
+}
+
+/**
+ * Returns a view of the current version that later changes
+ * do not affect
+ */
+PersistentBinarySearchTree::Snapshot PersistentBinarySearchTree::GetSnapshot() const {
+    return Snapshot(atomic_load(&root));
+}
+
+/**
+ * Insert a bid
+ */
+void PersistentBinarySearchTree::Insert(Bid bid) {
+    lock_guard<mutex> lock(writer);
+    publish(insert(atomic_load(&root), bid));
+}
+
+/**
+ * Remove a bid
+ */
+void PersistentBinarySearchTree::Remove(string bidId) {
+    lock_guard<mutex> lock(writer);
+    bool removed = false;
+    Link version = remove(atomic_load(&root), bidId, removed);
+    if (removed) {
+        publish(version);
+    }
+}
+
+/**
+ * Remove a batch of bids as one change: readers see either all
+ * of them or none of them gone
+ */
+void PersistentBinarySearchTree::RemoveAll(const vector<string>& bidIds) {
+    lock_guard<mutex> lock(writer);
+    Link version = atomic_load(&root);
+    for (auto const& bidId : bidIds) {
+        bool removed = false;
+        version = remove(version, bidId, removed);
+    }
+    publish(version);
+}
+
+/**
+ * Replace the whole tree with a set of bids, as a reload does.
+ * Readers keep the old version until they take a new snapshot.
+ *
+ * @param bids The bids, in any order
+ */
+void PersistentBinarySearchTree::BulkLoad(vector<Bid> bids) {
+    stable_sort(bids.begin(), bids.end(), [](const Bid& a, const Bid& b) {
+        return a.bidId < b.bidId;
+    });
+    Link version = build(bids, 0, bids.size());
+    lock_guard<mutex> lock(writer);
+    publish(version);
+}
+
+/**
+ * Search the current version for a bid
+ */
+Bid PersistentBinarySearchTree::Search(string bidId) const {
+    return GetSnapshot().Search(bidId);
+}
+
+/**
+ * Returns the number of nodes alive in every version of every
+ * persistent tree, to show old versions being freed
+ */
+size_t PersistentBinarySearchTree::LiveNodes() {
+    return liveNodes.load();
+}
+
+/**
+ * Search the snapshot for a bid, taking no locks
+ */
+Bid PersistentBinarySearchTree::Snapshot::Search(string bidId) const {
+    const PNode* current = root.get();
+    while (current != nullptr) {
+        int order = bidId.compare(current->bid.bidId);
+        if (order == 0) {
+            return current->bid;
+        }
+        current = order < 0 ? current->left.get() : current->right.get();
+    }
+    return Bid();
+}
+
+/**
+ * Output every bid in the snapshot in order
+ */
+void PersistentBinarySearchTree::Snapshot::InOrder(BufferedWriter& out) const {
+    vector<const PNode*> stack;
+    const PNode* node = root.get();
+    while (node != nullptr || !stack.empty()) {
+        while (node != nullptr) {
+            stack.push_back(node);
+            node = node->left.get();
+        }
+        node = stack.back();
+        stack.pop_back();
+        out << node->bid.bidId << ": "
+            << node->bid.title << " | "
+            << node->bid.amount << " | "
+            << node->bid.fund << '\n';
+        node = node->right.get();
+    }
+}
+
+/**
+ * Returns the number of bids in the snapshot
+ */
+int PersistentBinarySearchTree::Snapshot::Size() const {
+    return size(root);
+}
+
+//============================================================================
+// Concurrent Binary Search Tree class definition
+//============================================================================
+
+/**
+ * Define a class containing data members and methods to
+ * implement a binary search tree that many threads can search,
+ * insert into and remove from at the same time.
+ *
+ * Bids live only in the leaves, one leaf per bid id holding
+ * every bid with that id; inner nodes only route, sending ids
+ * less than their key left and the rest right. Each node has
+ * its own reader-writer lock, and every operation walks down
+ * hand over hand, locking a child before letting go of its
+ * parent. Searches take shared locks, so they run side by side;
+ * Insert and Remove take exclusive locks and hold at most the
+ * leaf and its two ancestors while they relink them.
+ *
+ * Because a node is only reached by locking its parent first, a
+ * writer that holds a removed node's parent and grandparent
+ * knows no other thread is on its way to it, so removed nodes
+ * are deleted at once.
+ *
+ * The tree is not rebalanced. BulkLoad builds a balanced tree,
+ * and random inserts keep it shallow on average.
+ */
+class ConcurrentBinarySearchTree {
+
+private:
+    struct CNode {
+        bool leaf;
+        string key; // routing key, or the id of every bid in a leaf
+        CNode* left;
+        CNode* right;
+        vector<Bid> bids; // leaves only, oldest first
+        shared_timed_mutex lock;
+
+        CNode(bool isLeaf, const string& aKey) :
+                leaf(isLeaf), key(aKey), left(nullptr), right(nullptr) {
+        }
+    };
+
+    // sentinel above the root, so every node has a parent to lock
+    CNode* head;
+    atomic<int> size;
+
+    static CNode* build(vector<CNode*>& leaves, size_t first, size_t last);
+
+public:
+    ConcurrentBinarySearchTree();
+    virtual ~ConcurrentBinarySearchTree();
+    ConcurrentBinarySearchTree(const ConcurrentBinarySearchTree&) = delete;
+    ConcurrentBinarySearchTree& operator=(const ConcurrentBinarySearchTree&) = delete;
+    void BulkLoad(vector<Bid> bids);
+    void Insert(Bid bid);
+    void Remove(string bidId);
+    Bid Search(string bidId);
+    int Size();
+};
+
+/**
+ * Default constructor
+ */
+ConcurrentBinarySearchTree::ConcurrentBinarySearchTree() : size(0) {
+    // the sentinel's only child, on the left, is the root
+    head = new CNode(false, string());
+}
+
+/**
+ * Destructor
+ */
+ConcurrentBinarySearchTree::~ConcurrentBinarySearchTree() {
+    vector<CNode*> stack;
+    stack.push_back(head);
+    while (!stack.empty()) {
+        CNode* node = stack.back();
+        stack.pop_back();
+        if (node->left != nullptr) {
+            stack.push_back(node->left);
+        }
+        if (node->right != nullptr) {
+            stack.push_back(node->right);
+        }
+        delete node;
+    }
+}
+
+/**
+ * Link leaves, already in order, into a balanced subtree. Each
+ * routing key is the first id of its right subtree.
+ *
+ * @param first Index of the first leaf of the subtree
+ * @param last One past the index of its last leaf
+ * @return the root of the subtree
+ */
+ConcurrentBinarySearchTree::CNode* ConcurrentBinarySearchTree::build(vector<CNode*>& leaves,
+        size_t first, size_t last) {
+    if (last - first == 1) {
+        return leaves[first];
+    }
+    size_t middle = first + (last - first) / 2;
+    CNode* node = new CNode(false, leaves[middle]->key);
+    node->left = build(leaves, first, middle);
+    node->right = build(leaves, middle, last);
+    return node;
+}
+
+/**
+ * Load bids into an empty tree as a balanced tree. This must
+ * run before other threads use the tree; on a tree that already
+ * holds bids it inserts them one at a time instead.
+ *
+ * @param bids The bids, in any order
+ */
+void ConcurrentBinarySearchTree::BulkLoad(vector<Bid> bids) {
+    if (head->left != nullptr) {
+        for (auto const& bid : bids) {
+            Insert(bid);
+        }
+        return;
+    }
+    stable_sort(bids.begin(), bids.end(), [](const Bid& a, const Bid& b) {
+        return a.bidId < b.bidId;
+    });
+
+    // one leaf for each run of equal ids
+    vector<CNode*> leaves;
+    for (auto& bid : bids) {
+        if (leaves.empty() || leaves.back()->key != bid.bidId) {
+            leaves.push_back(new CNode(true, bid.bidId));
+        }
+        leaves.back()->bids.push_back(move(bid));
+    }
+    if (!leaves.empty()) {
+        head->left = build(leaves, 0, leaves.size());
+    }
+    size += (int)bids.size();
+}
+
+/**
+ * Insert a bid
+ */
+void ConcurrentBinarySearchTree::Insert(Bid bid) {
+    CNode* parent = head;
+    parent->lock.lock();
+    CNode* node = head->left;
+    if (node == nullptr) {
+        head->left = new CNode(true, bid.bidId);
+        head->left->bids.push_back(bid);
+        size++;
+        parent->lock.unlock();
+        return;
+    }
+
+    // keep the leaf's parent locked too, to link in a new node
+    node->lock.lock();
+    while (!node->leaf) {
+        CNode* next = bid.bidId < node->key ? node->left : node->right;
+        next->lock.lock();
+        parent->lock.unlock();
+        parent = node;
+        node = next;
+    }
+
+    if (node->key == bid.bidId) {
+        node->bids.push_back(bid);
+    }
+    else {
+        // a new routing node takes the leaf's place, over the
+        // leaf and a new leaf for the bid
+        CNode* added = new CNode(true, bid.bidId);
+        added->bids.push_back(bid);
+        CNode* route;
+        if (bid.bidId < node->key) {
+            route = new CNode(false, node->key);
+            route->left = added;
+            route->right = node;
+        }
+        else {
+            route = new CNode(false, bid.bidId);
+            route->left = node;
+            route->right = added;
+        }
+        if (parent->left == node) {
+            parent->left = route;
+        }
+        else {
+            parent->right = route;
+        }
+    }
+    size++;
+    node->lock.unlock();
+    parent->lock.unlock();
+}
+
+/**
+ * Remove the oldest bid with a bid id
+ */
+void ConcurrentBinarySearchTree::Remove(string bidId) {
+    CNode* grand = nullptr;
+    CNode* parent = head;
+    parent->lock.lock();
+    CNode* node = head->left;
+    if (node == nullptr) {
+        parent->lock.unlock();
+        return;
+    }
+
+    // keep the leaf's parent and grandparent locked as well
+    node->lock.lock();
+    while (!node->leaf) {
+        CNode* next = bidId < node->key ? node->left : node->right;
+        next->lock.lock();
+        if (grand != nullptr) {
+            grand->lock.unlock();
+        }
+        grand = parent;
+        parent = node;
+        node = next;
+    }
+
+    CNode* removedLeaf = nullptr;
+    CNode* removedRoute = nullptr;
+    if (node->key == bidId) {
+        size--;
+        if (node->bids.size() > 1) {
+            node->bids.erase(node->bids.begin());
+        }
+        else if (parent == head) {
+            head->left = nullptr;
+            removedLeaf = node;
+        }
+        else {
+            // the leaf's sibling takes the parent's place
+            CNode* sibling = parent->left == node ? parent->right : parent->left;
+            if (grand->left == parent) {
+                grand->left = sibling;
+            }
+            else {
+                grand->right = sibling;
+            }
+            removedLeaf = node;
+            removedRoute = parent;
+        }
+    }
+    node->lock.unlock();
+    parent->lock.unlock();
+    if (grand != nullptr) {
+        grand->lock.unlock();
+    }
+    // nobody else can be waiting on these locks, as reaching them
+    // meant holding a lock this thread held
+    delete removedLeaf;
+    delete removedRoute;
+}
+
+/**
+ * Search for a bid, returning the oldest with its bid id
+ */
+Bid ConcurrentBinarySearchTree::Search(string bidId) {
+    head->lock.lock_shared();
+    CNode* node = head->left;
+    if (node == nullptr) {
+        head->lock.unlock_shared();
+        return Bid();
+    }
+    node->lock.lock_shared();
+    head->lock.unlock_shared();
+    while (!node->leaf) {
+        CNode* next = bidId < node->key ? node->left : node->right;
+        next->lock.lock_shared();
+        node->lock.unlock_shared();
+        node = next;
+    }
+
+    Bid bid;
+    if (node->key == bidId) {
+        bid = node->bids.front();
+    }
+    node->lock.unlock_shared();
+    return bid;
+}
+
+/**
+ * Returns the number of bids in the tree
+ */
+int ConcurrentBinarySearchTree::Size() {
+    return size.load();
+}
+
+//============================================================================
+// Static methods used for testing
+//============================================================================
+
+/**
+ * Display the bid information to the console (std::out)
+ *
+ * @param bid struct containing the bid info
+ */
+void displayBid(Bid bid) {
+    cout << bid.bidId << ": " << bid.title << " | " << bid.amount << " | "
+            << bid.fund << endl;
+    return;
+}
+
+/**
+ * Load a CSV file containing bids into a container
+ *
+ * @param csvPath the path to the CSV file to load
+ * @return a container holding all the bids read
+ */
+void loadBids(string csvPath, BinarySearchTree* bst) {
+    cout << "Loading CSV file " << csvPath << endl;
+
+    // initialize the CSV Parser using the given path
+    csv::Parser file = csv::Parser(csvPath);
+
+    // read and display header row - optional
+    vector<string> header = file.getHeader();
+    for (auto const& c : header) {
+        cout << c << " | ";
+    }
+    cout << "" << endl;
+
+    // collect every row, then build the tree in one pass
+    vector<Bid> bids;
+    bids.reserve(file.rowCount());
+
+    try {
+        // loop to read rows of a CSV file
+        for (unsigned int i = 0; i < file.rowCount(); i++) {
+
+            // Create a data structure and add to the collection of bids
+            Bid bid;
+            bid.bidId = file[i][1];
+            bid.title = file[i][0];
+            bid.fund = file[i][8];
+            bid.amount = strToDouble(file[i][4], '$');
+
+            //cout << "Item: " << bid.title << ", Fund: " << bid.fund << ", Amount: " << bid.amount << endl;
+
+            // push this bid to the end
+            bids.push_back(bid);
+        }
+    } catch (csv::Error &e) {
+        std::cerr << e.what() << std::endl;
+    }
+    // the rows read before any error are still loaded, as
+    // inserting them one at a time would have done
+    bst->BulkLoad(move(bids));
+}
+
+/**
+ * Measure the false positive rate of the Bloom filter and what
+ * it saves on root-to-leaf descents for bids that do not exist
+ *
+ * @param bst The loaded tree to search
+ * @param misses Number of missing bid ids to search for
+ */
+void benchmarkBloom(BinarySearchTree* bst, unsigned int misses) {
+    clock_t ticks;
+    unsigned int found = 0;
+
+    // the ids sort among the five digit ids the tree holds, so
+    // an unfiltered miss descends all the way to a leaf
+    vector<string> ids;
+    for (unsigned int i = 0; i < misses; ++i) {
+        ids.push_back(to_string(10000 + (i * 7919) % 90000) + "x");
+    }
+
+    bst->SetBloomFilter(false);
+    ticks = clock();
+    for (auto const& id : ids) {
+        found += bst->Search(id).bidId.empty() ? 0 : 1;
+    }
+    ticks = clock() - ticks;
+    cout << "without filter: " << ticks * 1.0e9 / CLOCKS_PER_SEC / max(misses, 1u)
+            << " nanoseconds per miss" << endl;
+
+    bst->SetBloomFilter(true);
+    BloomFilterStats before = bst->BloomStats();
+    ticks = clock();
+    for (auto const& id : ids) {
+        found += bst->Search(id).bidId.empty() ? 0 : 1;
+    }
+    ticks = clock() - ticks;
+    BloomFilterStats after = bst->BloomStats();
+    cout << "with filter: " << ticks * 1.0e9 / CLOCKS_PER_SEC / max(misses, 1u)
+            << " nanoseconds per miss" << endl;
+
+    size_t queries = after.queries - before.queries;
+    size_t positives = after.positives - before.positives;
+    cout << "false positive rate: " << (queries == 0 ? 0.0 : positives * 100.0 / queries)
+            << "% (" << positives << " of " << queries << ")" << endl;
+    cout << "filter: " << after.keys << " keys in " << after.bytes << " bytes" << endl;
+    cout << found << " unexpected hits" << endl;
+}
+
+/**
+ * Create a synthetic bid for benchmarks larger than the CSV files
+ *
+ * @param n Sequence number used as the bid id
+ * @return a bid with the given id
+ */
+Bid makeBid(unsigned int n) {
+    Bid bid;
+    bid.bidId = to_string(n);
+    bid.title = "Synthetic Bid " + bid.bidId;
+    bid.fund = (n % 2 == 0) ? "General Fund" : "Enterprise";
+    bid.amount = (n % 100000) / 100.0;
+    return bid;
+}
+
+/**
+ * Check that a bulk load and one-at-a-time inserts into the
+ * plain tree find the same copy of a repeated bid id
+ */
+void checkDuplicateIds() {
+    vector<Bid> bids;
+    for (unsigned int i = 0; i < 5; ++i) {
+        Bid bid = makeBid(1000 + i);
+        bids.push_back(bid);
+        bid.bidId = "1002";
+        bid.title = "Copy " + to_string(i + 1);
+        bids.push_back(bid);
+    }
+
+    BinarySearchTree* inserted = new BinarySearchTree();
+    for (auto const& bid : bids) {
+        inserted->Insert(bid);
+    }
+    BinarySearchTree* loaded = new BinarySearchTree();
+    loaded->BulkLoad(bids);
+
+    string expected = inserted->Search("1002").title;
+    string actual = loaded->Search("1002").title;
+    cout << "duplicate ids: insert finds " << expected << ", bulk load finds " << actual
+         << (expected == actual ? "" : " (MISMATCH)") << endl;
+    delete inserted;
+    delete loaded;
+}
+
+/**
+ * Compare the plain tree against the balanced tree for sorted,
+ * reverse-sorted and random insertion orders
+ *
+ * @param count Number of synthetic bids to insert
+ */
+void benchmarkBalanced(unsigned int count) {
+    const char* orders[3] = { "sorted", "reverse", "random" };
+    const char* names[2] = { "plain", "balanced" };
+
+    // zero padded ids so string order matches insertion order
+    vector<Bid> bids;
+    for (unsigned int i = 0; i < count; ++i) {
+        Bid bid = makeBid(i);
+        bid.bidId = string(10 - min<size_t>(bid.bidId.size(), 10), '0') + bid.bidId;
+        bids.push_back(bid);
+    }
+
+    for (int o = 0; o < 3; ++o) {
+        if (o == 1) {
+            reverse(bids.begin(), bids.end());
+        }
+        else if (o == 2) {
+            shuffle(bids.begin(), bids.end(), mt19937(1));
+        }
+
+        for (int b = 0; b < 2; ++b) {
+            // a sorted insert into the plain tree walks every level,
+            // so building it is quadratic; keep it small
+            if (b == 0 && o < 2 && count > 20000) {
+                cout << orders[o] << " " << names[b] << ": skipped above 20000 bids" << endl;
+                continue;
+            }
+            BinarySearchTree* tree = new BinarySearchTree();
+            tree->SetBalanced(b == 1);
+
+            clock_t ticks = clock();
+            for (auto const& bid : bids) {
+                tree->Insert(bid);
+            }
+            double insertTime = (clock() - ticks) * 1.0 / CLOCKS_PER_SEC;
+
+            unsigned int found = 0;
+            ticks = clock();
+            for (auto const& bid : bids) {
+                found += tree->Search(bid.bidId).bidId.empty() ? 0 : 1;
+            }
+            double searchTime = (clock() - ticks) * 1.0 / CLOCKS_PER_SEC;
+
+            cout << orders[o] << " " << names[b] << ": height " << tree->Height()
+                 << ", insert " << insertTime << " seconds, search " << searchTime
+                 << " seconds (" << found << " found)" << endl;
+            delete tree;
+        }
+    }
+
+    checkDuplicateIds();
+}
+
+/**
+ * Compare lookup latency in the balanced binary tree against the
+ * B+ tree. With a million bids or more the trees are far larger
+ * than the last-level cache, so each lookup mostly pays for the
+ * cache misses along its path.
+ *
+ * @param count Number of synthetic bids in each tree
+ * @param lookups Number of random lookups of present bids
+ */
+void benchmarkBPlusTree(unsigned int count, unsigned int lookups) {
+    vector<Bid> bids;
+    for (unsigned int i = 0; i < count; ++i) {
+        bids.push_back(makeBid(i));
+    }
+    mt19937 random(1);
+    shuffle(bids.begin(), bids.end(), random);
+
+    vector<string> ids;
+    for (unsigned int i = 0; i < lookups && count > 0; ++i) {
+        ids.push_back(bids[random() % count].bidId);
+    }
+
+    BinarySearchTree* tree = new BinarySearchTree();
+    tree->SetBalanced(true);
+    clock_t ticks = clock();
+    for (auto const& bid : bids) {
+        tree->Insert(bid);
+    }
+    cout << "balanced tree: insert " << (clock() - ticks) * 1.0 / CLOCKS_PER_SEC
+         << " seconds, height " << tree->Height() << endl;
+
+    BPlusTree* bPlusTree = new BPlusTree();
+    ticks = clock();
+    for (auto const& bid : bids) {
+        bPlusTree->Insert(bid);
+    }
+    cout << "B+ tree: insert " << (clock() - ticks) * 1.0 / CLOCKS_PER_SEC
+         << " seconds, height " << bPlusTree->Height() << endl;
+
+    unsigned int found = 0;
+    ticks = clock();
+    for (auto const& id : ids) {
+        found += tree->Search(id).bidId.empty() ? 0 : 1;
+    }
+    ticks = clock() - ticks;
+    cout << "balanced tree: " << ticks * 1.0e9 / CLOCKS_PER_SEC / max(lookups, 1u)
+         << " nanoseconds per lookup (" << found << " found)" << endl;
+
+    found = 0;
+    ticks = clock();
+    for (auto const& id : ids) {
+        found += bPlusTree->Search(id).bidId.empty() ? 0 : 1;
+    }
+    ticks = clock() - ticks;
+    cout << "B+ tree: " << ticks * 1.0e9 / CLOCKS_PER_SEC / max(lookups, 1u)
+         << " nanoseconds per lookup (" << found << " found)" << endl;
+
+    delete tree;
+    delete bPlusTree;
+}
+
+/**
+ * Compare lookups in the pointer tree, the frozen Eytzinger
+ * arrays and a std::lower_bound over a sorted vector of ids
+ * with the bids in a parallel vector. Every lookup returns a
+ * copy of the bid, as Search does.
+ *
+ * @param count Number of synthetic bids in the tree
+ * @param lookups Number of random lookups of present bids
+ */
+void benchmarkFrozen(unsigned int count, unsigned int lookups) {
+    vector<Bid> bids;
+    for (unsigned int i = 0; i < count; ++i) {
+        bids.push_back(makeBid(i));
+    }
+    mt19937 random(1);
+    vector<string> ids;
+    for (unsigned int i = 0; i < lookups && count > 0; ++i) {
+        ids.push_back(bids[random() % count].bidId);
+    }
+
+    BinarySearchTree* tree = new BinarySearchTree();
+    tree->SetBalanced(true);
+    tree->BulkLoad(move(bids));
+    vector<string> sortedIds;
+    vector<Bid> sortedBids;
+    for (auto const& bid : *tree) {
+        sortedIds.push_back(bid.bidId);
+        sortedBids.push_back(bid);
+    }
+
+    unsigned int found = 0;
+    clock_t ticks = clock();
+    for (auto const& id : ids) {
+        found += tree->Search(id).bidId.empty() ? 0 : 1;
+    }
+    ticks = clock() - ticks;
+    cout << "pointer tree: " << ticks * 1.0e9 / CLOCKS_PER_SEC / max(lookups, 1u)
+         << " nanoseconds per lookup (" << found << " found)" << endl;
+
+    ticks = clock();
+    tree->Freeze();
+    cout << "freeze: " << (clock() - ticks) * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+
+    found = 0;
+    ticks = clock();
+    for (auto const& id : ids) {
+        found += tree->Search(id).bidId.empty() ? 0 : 1;
+    }
+    ticks = clock() - ticks;
+    cout << "frozen tree: " << ticks * 1.0e9 / CLOCKS_PER_SEC / max(lookups, 1u)
+         << " nanoseconds per lookup (" << found << " found)" << endl;
+
+    found = 0;
+    ticks = clock();
+    for (auto const& id : ids) {
+        auto it = lower_bound(sortedIds.begin(), sortedIds.end(), id);
+        Bid bid;
+        if (it != sortedIds.end() && *it == id) {
+            bid = sortedBids[it - sortedIds.begin()];
+        }
+        found += bid.bidId.empty() ? 0 : 1;
+    }
+    ticks = clock() - ticks;
+    cout << "sorted vector: " << ticks * 1.0e9 / CLOCKS_PER_SEC / max(lookups, 1u)
+         << " nanoseconds per lookup (" << found << " found)" << endl;
+
+    delete tree;
+}
+
+/**
+ * Run reader threads against a persistent tree while a writer
+ * reloads it and removes the odd ids as one batch, over and
+ * over. Every snapshot must show either the full set or the
+ * even ids only, never a mix.
+ *
+ * @param threads Number of reader threads
+ * @param count Number of bids in a full load
+ * @param rounds Number of reload and remove rounds
+ */
+void stressSnapshots(unsigned int threads, unsigned int count, unsigned int rounds) {
+    PersistentBinarySearchTree* tree = new PersistentBinarySearchTree();
+    vector<Bid> bids;
+    vector<string> odd;
+    for (unsigned int i = 0; i < count; ++i) {
+        bids.push_back(makeBid(i));
+        if (i % 2 == 1) {
+            odd.push_back(bids.back().bidId);
+        }
+    }
+    tree->BulkLoad(bids);
+
+    atomic<bool> done(false);
+    atomic<unsigned int> searches(0);
+    atomic<unsigned int> wrong(0);
+    vector<thread> readers;
+
+    auto start = chrono::steady_clock::now();
+    for (unsigned int t = 0; t < threads; ++t) {
+        readers.push_back(thread([=, &done, &searches, &wrong]() {
+            mt19937 random(t + 1);
+            while (!done.load()) {
+                PersistentBinarySearchTree::Snapshot snapshot = tree->GetSnapshot();
+                bool full = snapshot.Size() == (int)count;
+                if (!full && snapshot.Size() != (int)(count - odd.size())) {
+                    wrong++;
+                }
+                // a few lookups against the same point in time
+                for (int i = 0; i < 16 && count > 0; ++i) {
+                    unsigned int n = random() % count;
+                    bool present = full || n % 2 == 0;
+                    if (present == snapshot.Search(to_string(n)).bidId.empty()) {
+                        wrong++;
+                    }
+                    searches++;
+                }
+            }
+        }));
+    }
+    for (unsigned int round = 0; round < rounds; ++round) {
+        tree->RemoveAll(odd);
+        tree->BulkLoad(bids);
+    }
+    done.store(true);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+    cout << "searches: " << searches.load() << " during the run, "
+         << wrong.load() << " inconsistent" << endl;
+    cout << "live nodes: " << PersistentBinarySearchTree::LiveNodes()
+         << " (current version has " << tree->GetSnapshot().Size() << ")" << endl;
+    cout << "time: " << elapsed.count() << " seconds" << endl;
+
+    delete tree;
+}
+
+/**
+ * Measure the throughput of a read-mostly mix of operations on
+ * one shared tree, for the fine-grained concurrent tree and for
+ * the balanced tree behind a single mutex, at 1, 2, 4 ... up to
+ * the given number of threads. Each operation is a search 90%
+ * of the time, else an insert or a remove, on random ids of
+ * which half are loaded at the start.
+ *
+ * @param maxThreads Largest number of threads to run
+ * @param count Number of bids loaded at the start
+ * @param operations Number of operations shared out among the threads
+ */
+void benchmarkConcurrentTree(unsigned int maxThreads, unsigned int count, unsigned int operations) {
+    // bids and ids are made up front so only the operations are timed
+    vector<Bid> bids;
+    for (unsigned int i = 0; i < 2 * count; ++i) {
+        bids.push_back(makeBid(i));
+    }
+    vector<Bid> loaded;
+    for (unsigned int i = 0; i < count; ++i) {
+        loaded.push_back(bids[2 * i]);
+    }
+
+    for (unsigned int threads = 1; threads <= max(maxThreads, 1u); threads *= 2) {
+        unsigned int share = (operations + threads - 1) / threads;
+
+        // every thread runs the same mix against each tree
+        auto run = [&](function<void(unsigned int, unsigned int)> operation) {
+            vector<thread> workers;
+            // clock() adds up every thread's processor time, so time the wall clock
+            auto start = chrono::steady_clock::now();
+            for (unsigned int t = 0; t < threads; ++t) {
+                workers.push_back(thread([&, t]() {
+                    mt19937 random(t + 1);
+                    for (unsigned int i = 0; i < share && !bids.empty(); ++i) {
+                        unsigned int n = random() % bids.size();
+                        operation(random() % 20, n);
+                    }
+                }));
+            }
+            for (auto& worker : workers) {
+                worker.join();
+            }
+            chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+            return elapsed.count();
+        };
+
+        ConcurrentBinarySearchTree* fine = new ConcurrentBinarySearchTree();
+        fine->BulkLoad(loaded);
+        double fineTime = run([&](unsigned int kind, unsigned int n) {
+            if (kind == 0) {
+                fine->Insert(bids[n]);
+            }
+            else if (kind == 1) {
+                fine->Remove(bids[n].bidId);
+            }
+            else {
+                fine->Search(bids[n].bidId);
+            }
+        });
+
+        BinarySearchTree* locked = new BinarySearchTree();
+        locked->SetBalanced(true);
+        locked->BulkLoad(loaded);
+        mutex lock;
+        double lockedTime = run([&](unsigned int kind, unsigned int n) {
+            lock_guard<mutex> hold(lock);
+            if (kind == 0) {
+                locked->Insert(bids[n]);
+            }
+            else if (kind == 1) {
+                locked->Remove(bids[n].bidId);
+            }
+            else {
+                locked->Search(bids[n].bidId);
+            }
+        });
+
+        double total = (double)share * threads;
+        cout << threads << " threads: fine-grained " << total / max(fineTime, 1e-9)
+             << " operations/second (" << fine->Size() << " bids), mutex "
+             << total / max(lockedTime, 1e-9) << " operations/second ("
+             << locked->Size() << " bids)" << endl;
+
+        delete fine;
+        delete locked;
+    }
+}
+
+/**
+ * Compare the nodes visited per search in the plain, balanced
+ * and splay trees when a few bids take most of the searches.
+ * Lookups follow a Zipf distribution: the bid of popularity
+ * rank r is searched with probability proportional to 1 / r^s,
+ * and the ranks are dealt out to random bids.
+ *
+ * @param count Number of synthetic bids in each tree
+ * @param lookups Number of searches
+ * @param skew The Zipf exponent s; 1 is typical, 0 is uniform
+ */
+void benchmarkSplay(unsigned int count, unsigned int lookups, double skew) {
+    vector<Bid> bids;
+    for (unsigned int i = 0; i < count; ++i) {
+        bids.push_back(makeBid(i));
+    }
+    mt19937 random(1);
+    shuffle(bids.begin(), bids.end(), random);
+
+    // popularity is dealt out independently of insertion order,
+    // so the hot bids are not simply the ones near the root
+    vector<unsigned int> popular;
+    for (unsigned int i = 0; i < count; ++i) {
+        popular.push_back(i);
+    }
+    shuffle(popular.begin(), popular.end(), random);
+
+    // cumulative weights by rank; rank r is bids[popular[r]]
+    vector<double> cumulative;
+    double total = 0.0;
+    for (unsigned int r = 1; r <= count; ++r) {
+        total += 1.0 / pow((double)r, skew);
+        cumulative.push_back(total);
+    }
+    uniform_real_distribution<double> uniform(0.0, total);
+    vector<string> ids;
+    for (unsigned int i = 0; i < lookups && count > 0; ++i) {
+        size_t rank = lower_bound(cumulative.begin(), cumulative.end(), uniform(random))
+                      - cumulative.begin();
+        ids.push_back(bids[popular[min(rank, (size_t)count - 1)]].bidId);
+    }
+
+    const char* names[] = { "plain", "balanced", "splay" };
+    for (int mode = 0; mode < 3; ++mode) {
+        // the shuffled order keeps the plain tree from degenerating
+        BinarySearchTree* tree = new BinarySearchTree();
+        tree->SetBalanced(mode == 1);
+        for (auto const& bid : bids) {
+            tree->Insert(bid);
+        }
+        tree->SetSplay(mode == 2);
+        int height = tree->Height();
+
+        ScanStats before = tree->SearchStats();
+        clock_t ticks = clock();
+        for (auto const& id : ids) {
+            tree->Search(id);
+        }
+        ticks = clock() - ticks;
+        ScanStats after = tree->SearchStats();
+
+        unsigned long long searches = max(after.searches - before.searches, 1ULL);
+        cout << names[mode] << " tree (height " << height << "): "
+             << (after.nodes - before.nodes) * 1.0 / searches << " nodes per search, "
+             << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+        delete tree;
+    }
+}
+
+/**
+ * Display the allocation statistics of a node pool
+ *
+ * @param stats statistics reported by the pool
+ */
+void displayPoolStats(NodePoolStats stats) {
+    cout << "slabs: " << stats.slabs << " (" << stats.bytes << " bytes)" << endl;
+    cout << "nodes: " << stats.live << " live of " << stats.capacity << " capacity" << endl;
+    cout << "allocations: " << stats.allocations << " (" << stats.reuses
+         << " from free list)" << endl;
+}
+
+/**
+ * Simple C function to convert a string to a double
+ * after stripping out unwanted char
+ *
+ * credit: http://stackoverflow.com/a/24875936
+ *
+ * @param ch The character to strip out
+ */
+double strToDouble(string str, char ch) {
+    str.erase(remove(str.begin(), str.end(), ch), str.end());
+    return atof(str.c_str());
+}
+
+/**
+ * The one and only main() method
+ */
+int main(int argc, char* argv[]) {
 
     // process command line arguments
     string csvPath;
@@ -424,7 +3078,20 @@ int main(int argc, char* argv[]) {
     // Define a binary search tree to hold all bids
     BinarySearchTree* bst;
     bst = new BinarySearchTree();
+    bst->SetBloomFilter(true);
+    // sorted exports would otherwise make the tree a linked list
+    bool balanced = true;
+    bst->SetBalanced(balanced);
     Bid bid;
+    unsigned int count = 0;
+    unsigned int lookups = 0;
+    unsigned int threads = 0;
+    unsigned int rounds = 0;
+    bool splayed = false;
+    double skew = 1.0;
+    string low;
+    string high;
+    vector<Bid> bids;
 
     int choice = 0;
     while (choice != 9) {
@@ -433,6 +3100,19 @@ int main(int argc, char* argv[]) {
         cout << "  2. Display All Bids" << endl;
         cout << "  3. Find Bid" << endl;
         cout << "  4. Remove Bid" << endl;
+        cout << "  5. Benchmark Bloom Filter" << endl;
+        cout << "  6. Toggle Balanced Tree" << endl;
+        cout << "  7. Benchmark Balanced Tree" << endl;
+        cout << "  8. Benchmark B+ Tree" << endl;
+        cout << "  10. Find Bids by Id Range" << endl;
+        cout << "  11. Find Bid by Position" << endl;
+        cout << "  12. Freeze Tree" << endl;
+        cout << "  13. Benchmark Frozen Tree" << endl;
+        cout << "  14. Show Node Pool Statistics" << endl;
+        cout << "  15. Stress Test Snapshot Readers" << endl;
+        cout << "  16. Benchmark Concurrent Tree" << endl;
+        cout << "  17. Toggle Splay Tree" << endl;
+        cout << "  18. Benchmark Splay Tree" << endl;
         cout << "  9. Exit" << endl;
         cout << "Enter choice: ";
         cin >> choice;
@@ -447,7 +3127,7 @@ int main(int argc, char* argv[]) {
             // Complete the method call to load the bids
             loadBids(csvPath, bst);
 
-            //cout << bst->Size() << " bids read" << endl;
+            cout << bst->Size() << " bids read" << endl;
 
             // Calculate elapsed time and display result
             ticks = clock() - ticks; // current clock ticks minus starting clock ticks
@@ -480,6 +3160,135 @@ int main(int argc, char* argv[]) {
         case 4:
             bst->Remove(bidKey);
             break;
+
+        case 5:
+            cout << "Number of missing bids to search for: ";
+            cin >> count;
+            benchmarkBloom(bst, count);
+            break;
+
+        case 6:
+            balanced = !balanced;
+            bst->SetBalanced(balanced);
+            if (balanced) {
+                splayed = false;
+            }
+            cout << "Balanced tree " << (balanced ? "on" : "off")
+                 << ", height " << bst->Height() << endl;
+            break;
+
+        case 7:
+            cout << "Number of bids: ";
+            cin >> count;
+            benchmarkBalanced(count);
+            break;
+
+        case 8:
+            cout << "Number of bids: ";
+            cin >> count;
+            cout << "Number of lookups: ";
+            cin >> lookups;
+            benchmarkBPlusTree(count, lookups);
+            break;
+
+        case 10:
+            cout << "Enter lowest bid id: ";
+            cin >> low;
+            cout << "Enter highest bid id: ";
+            cin >> high;
+
+            ticks = clock();
+            bids = bst->RangeScan(low, high);
+            ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+
+            for (auto const& found : bids) {
+                displayBid(found);
+            }
+            cout << bids.size() << " bids found" << endl;
+            cout << "time: " << ticks << " clock ticks" << endl;
+            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+            bids.clear();
+            break;
+
+        case 11:
+            cout << bst->Size() << " bids, median id " << bst->Select(bst->Size() / 2).bidId << endl;
+            cout << "Enter position (0 for the first bid): ";
+            cin >> count;
+
+            ticks = clock();
+            bid = bst->Select(count);
+            ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+
+            if (!bid.bidId.empty()) {
+                displayBid(bid);
+                cout << bst->Rank(bid.bidId) << " bids have a lower id" << endl;
+            } else {
+                cout << "No bid at position " << count << "." << endl;
+            }
+            cout << "time: " << ticks << " clock ticks" << endl;
+            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+            break;
+
+        case 12:
+            ticks = clock();
+            bst->Freeze();
+            ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+
+            cout << "Tree frozen until the next change" << endl;
+            cout << "time: " << ticks << " clock ticks" << endl;
+            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+            break;
+
+        case 13:
+            cout << "Number of bids: ";
+            cin >> count;
+            cout << "Number of lookups: ";
+            cin >> lookups;
+            benchmarkFrozen(count, lookups);
+            break;
+
+        case 14:
+            displayPoolStats(bst->PoolStats());
+            break;
+
+        case 15:
+            cout << "Number of reader threads: ";
+            cin >> threads;
+            cout << "Number of bids: ";
+            cin >> count;
+            cout << "Number of rounds: ";
+            cin >> rounds;
+            stressSnapshots(threads, count, rounds);
+            break;
+
+        case 16:
+            cout << "Largest number of threads: ";
+            cin >> threads;
+            cout << "Number of bids: ";
+            cin >> count;
+            cout << "Number of operations: ";
+            cin >> lookups;
+            benchmarkConcurrentTree(threads, count, lookups);
+            break;
+
+        case 17:
+            splayed = !splayed;
+            bst->SetSplay(splayed);
+            if (splayed) {
+                balanced = false;
+            }
+            cout << "Splay tree " << (splayed ? "on" : "off") << endl;
+            break;
+
+        case 18:
+            cout << "Number of bids: ";
+            cin >> count;
+            cout << "Number of lookups: ";
+            cin >> lookups;
+            cout << "Zipf exponent (1 is typical): ";
+            cin >> skew;
+            benchmarkSplay(count, lookups, skew);
+            break;
         }
     }
 
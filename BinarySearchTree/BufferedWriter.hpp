@@ -0,0 +1,229 @@
+#ifndef     _BUFFEREDWRITER_HPP_
+# define    _BUFFEREDWRITER_HPP_
+
+# include <cmath>
+# include <cstdio>
+# include <cstring>
+# include <iostream>
+# include <string>
+# include <vector>
+
+# ifdef _WIN32
+#  include <fcntl.h>
+#  include <io.h>
+#  include <sys/stat.h>
+# else
+#  include <cerrno>
+#  include <fcntl.h>
+#  include <unistd.h>
+# endif
+
+/**
+ * Bulk output for bid listings.
+ *
+ * Text is formatted straight into one large reusable buffer,
+ * integers and amounts by hand rather than through iostreams,
+ * and the buffer is handed to the operating system in a single
+ * write call whenever it fills. Dumping millions of bids costs
+ * a few hundred system calls instead of one flush per line.
+ *
+ * A writer targets standard output (a terminal, pipe or
+ * redirected file) or a file it creates itself.
+ */
+class BufferedWriter
+{
+    private:
+        static const size_t BUFFER_SIZE = 1 << 16;
+
+        std::vector<char> _buffer;
+        size_t _used;
+        int _fd;
+        bool _owned;
+        bool _good;
+
+        // hand the bytes to the operating system, retrying short writes
+        void writeAll(const char *data, size_t length)
+        {
+            while (_good && length > 0)
+            {
+# ifdef _WIN32
+                int written = _write(_fd, data, (unsigned int)length);
+# else
+                ssize_t written = ::write(_fd, data, length);
+                if (written < 0 && errno == EINTR)
+                    continue;
+# endif
+                if (written <= 0)
+                {
+                    _good = false;
+                    return;
+                }
+                data += written;
+                length -= written;
+            }
+        }
+
+        void append(const char *data, size_t length)
+        {
+            if (_used + length > _buffer.size())
+            {
+                Flush();
+                // anything larger than the buffer goes out directly
+                if (length > _buffer.size())
+                {
+                    writeAll(data, length);
+                    return;
+                }
+            }
+            memcpy(&_buffer[_used], data, length);
+            _used += length;
+        }
+
+    public:
+        /**
+         * Write to standard output
+         */
+        BufferedWriter(void) :
+            _buffer(BUFFER_SIZE), _used(0), _fd(1), _owned(false), _good(true)
+        {
+            // keep anything already sent through cout ahead of our output
+            std::cout.flush();
+        }
+
+        /**
+         * Create or truncate a file and write to it
+         */
+        BufferedWriter(const std::string &path) :
+            _buffer(BUFFER_SIZE), _used(0), _owned(true)
+        {
+# ifdef _WIN32
+            _fd = _open(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY,
+                _S_IREAD | _S_IWRITE);
+# else
+            _fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+# endif
+            _good = _fd >= 0;
+        }
+
+        ~BufferedWriter(void)
+        {
+            Flush();
+            if (_owned && _fd >= 0)
+            {
+# ifdef _WIN32
+                _close(_fd);
+# else
+                ::close(_fd);
+# endif
+            }
+        }
+
+        BufferedWriter(const BufferedWriter &) = delete;
+        BufferedWriter &operator=(const BufferedWriter &) = delete;
+
+        void Flush(void)
+        {
+            writeAll(_buffer.data(), _used);
+            _used = 0;
+        }
+
+        /**
+         * false once the file could not be opened or a write failed
+         */
+        bool Good(void) const
+        {
+            return _good;
+        }
+
+        BufferedWriter &operator<<(const std::string &text)
+        {
+            append(text.data(), text.size());
+            return *this;
+        }
+
+        BufferedWriter &operator<<(const char *text)
+        {
+            append(text, strlen(text));
+            return *this;
+        }
+
+        BufferedWriter &operator<<(char c)
+        {
+            if (_used == _buffer.size())
+                Flush();
+            _buffer[_used++] = c;
+            return *this;
+        }
+
+        BufferedWriter &operator<<(unsigned long long value)
+        {
+            char digits[20];
+            size_t count = 0;
+            do
+            {
+                digits[count++] = (char)('0' + value % 10);
+                value /= 10;
+            } while (value != 0);
+
+            if (_used + count > _buffer.size())
+                Flush();
+            while (count > 0)
+                _buffer[_used++] = digits[--count];
+            return *this;
+        }
+
+        BufferedWriter &operator<<(unsigned long value)
+        {
+            return *this << (unsigned long long)value;
+        }
+
+        BufferedWriter &operator<<(unsigned int value)
+        {
+            return *this << (unsigned long long)value;
+        }
+
+        BufferedWriter &operator<<(int value)
+        {
+            if (value < 0)
+            {
+                *this << '-';
+                return *this << (unsigned long long)(-(long long)value);
+            }
+            return *this << (unsigned long long)value;
+        }
+
+        /**
+         * Doubles print exactly as cout's default format does: %g with
+         * six significant digits. An amount held to the cent below
+         * 10000 has at most six digits, so 57, 83.99 and 225.5 are
+         * written directly; any other value goes through snprintf.
+         */
+        BufferedWriter &operator<<(double value)
+        {
+            double scaled = std::fabs(value) * 100.0;
+            long long cents = scaled < 1e6 ? std::llround(scaled) : -1;
+            bool isCents = cents == 0 ? scaled == 0.0
+                : cents > 0 && std::fabs(scaled - (double)cents) <= (double)cents * 1e-9;
+            if (!isCents)
+            {
+                char text[32];
+                int length = snprintf(text, sizeof(text), "%g", value);
+                append(text, length > 0 ? (size_t)length : 0);
+                return *this;
+            }
+
+            if (std::signbit(value))
+                *this << '-';
+            *this << (unsigned long long)(cents / 100);
+            int fraction = (int)(cents % 100);
+            if (fraction != 0)
+            {
+                *this << '.' << (char)('0' + fraction / 10);
+                if (fraction % 10 != 0)
+                    *this << (char)('0' + fraction % 10);
+            }
+            return *this;
+        }
+};
+
+#endif /*!_BUFFEREDWRITER_HPP_*/
@@ -0,0 +1,155 @@
+#ifndef     _BLOOMFILTER_HPP_
+# define    _BLOOMFILTER_HPP_
+
+# include <cstddef>
+# include <cstdint>
+# include <string>
+# include <vector>
+
+/**
+ * Statistics reported by a BloomFilter
+ */
+struct BloomFilterStats
+{
+    size_t blocks;     // 64-byte blocks in the filter
+    size_t bytes;      // bytes used by the blocks
+    size_t keys;       // keys added since the last rebuild
+    size_t stale;      // keys removed from the container since then
+    size_t queries;    // MayContain calls
+    size_t positives;  // MayContain calls that answered true
+};
+
+/**
+ * Blocked Bloom filter over bid ids.
+ *
+ * Each key selects one 64-byte block (one cache line) and sets
+ * one bit in each of its eight 64-bit words, so both adding and
+ * testing a key touch a single cache line. At the default ten
+ * bits per key the false positive rate is a little under 1%.
+ *
+ * Bits cannot be cleared, so removals are only counted. The
+ * owning container rebuilds the filter from its contents once
+ * NeedsRebuild() reports too many stale keys or too many keys
+ * for the current size.
+ */
+class BloomFilter
+{
+    private:
+        static const size_t WORDS_PER_BLOCK = 8;
+        static const size_t BITS_PER_KEY = 10;
+
+        std::vector<uint64_t> _words;
+        uint64_t *_blocks;
+        size_t _blockCount;
+        size_t _capacity;
+        mutable BloomFilterStats _stats;
+
+        // FNV-1a followed by a finalizing mix
+        static uint64_t hash(const std::string &key)
+        {
+            uint64_t h = 14695981039346656037ULL;
+            for (unsigned char c : key)
+            {
+                h ^= c;
+                h *= 1099511628211ULL;
+            }
+            h ^= h >> 33;
+            h *= 0xC4CEB9FE1A85EC53ULL;
+            h ^= h >> 33;
+            return h;
+        }
+
+        // the upper half of the hash picks the block
+        size_t blockIndex(uint64_t h) const
+        {
+            return (size_t)((h >> 32) * _blockCount >> 32) * WORDS_PER_BLOCK;
+        }
+
+        // the lower half, scattered by an odd salt per word, picks each bit
+        static uint64_t mask(uint64_t h, size_t word)
+        {
+            static const uint32_t SALT[WORDS_PER_BLOCK] = {
+                0x47B6137BU, 0x44974D91U, 0x8824AD5BU, 0xA2B7289DU,
+                0x705495C7U, 0x2DF1424BU, 0x9EFC4947U, 0x5C6BFB31U
+            };
+            return 1ULL << ((uint32_t)h * SALT[word] >> 26);
+        }
+
+    public:
+        BloomFilter(size_t expected = 1024)
+        {
+            Clear(expected);
+        }
+
+        BloomFilter(const BloomFilter &) = delete;
+        BloomFilter &operator=(const BloomFilter &) = delete;
+
+        /**
+         * Empty the filter and size it for an expected key count
+         */
+        void Clear(size_t expected)
+        {
+            if (expected < 64)
+                expected = 64;
+            _capacity = expected;
+            _blockCount = (expected * BITS_PER_KEY + 511) / 512;
+            // over-allocate one block so the blocks start on a cache line
+            _words.assign((_blockCount + 1) * WORDS_PER_BLOCK, 0);
+            uintptr_t start = reinterpret_cast<uintptr_t>(_words.data());
+            _blocks = _words.data() + ((64 - start % 64) % 64) / sizeof(uint64_t);
+            _stats.blocks = _blockCount;
+            _stats.bytes = _blockCount * WORDS_PER_BLOCK * sizeof(uint64_t);
+            _stats.keys = 0;
+            _stats.stale = 0;
+            _stats.queries = 0;
+            _stats.positives = 0;
+        }
+
+        void Add(const std::string &key)
+        {
+            uint64_t h = hash(key);
+            uint64_t *words = _blocks + blockIndex(h);
+            for (size_t i = 0; i < WORDS_PER_BLOCK; ++i)
+                words[i] |= mask(h, i);
+            _stats.keys++;
+        }
+
+        /**
+         * false means the key was never added; true means it may have been
+         */
+        bool MayContain(const std::string &key) const
+        {
+            uint64_t h = hash(key);
+            const uint64_t *words = _blocks + blockIndex(h);
+            bool found = true;
+            for (size_t i = 0; i < WORDS_PER_BLOCK; ++i)
+                found &= (words[i] & mask(h, i)) != 0;
+            _stats.queries++;
+            _stats.positives += found ? 1 : 0;
+            return found;
+        }
+
+        /**
+         * Note that a key was removed from the container
+         */
+        void Removed(void)
+        {
+            _stats.stale++;
+        }
+
+        /**
+         * true once a quarter of the keys are stale or the filter
+         * holds twice the keys it was sized for
+         */
+        bool NeedsRebuild(void) const
+        {
+            return _stats.stale * 4 > _stats.keys || _stats.keys > _capacity * 2;
+        }
+
+        const BloomFilterStats &Stats(void) const
+        {
+            return _stats;
+        }
+};
+
+#endif /*!_BLOOMFILTER_HPP_*/
@@ -7,12 +7,32 @@
 //============================================================================
 
 #include <algorithm>
+#include <cctype>
 #include <climits>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <map>
+#include <random>
 #include <string> // atoi
 #include <time.h>
+#include <unordered_map>
+#include <unordered_set>
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "BloomFilter.hpp"
+#include "BufferedWriter.hpp"
 #include "CSVparser.hpp"
+#include "NodePool.hpp"
 
 using namespace std;
 
@@ -24,6 +44,7 @@ const unsigned int DEFAULT_SIZE = 17000;
 
 // forward declarations
 double strToDouble(string str, char ch);
+uint64_t hashString(const string& str);
 
 // define a structure to hold bid information
 struct Bid {
@@ -38,6 +59,294 @@ struct Bid {
 
 void displayBid(Bid bid);
 
+//============================================================================
+// Perfect Hash Table class definition
+//============================================================================
+
+/**
+ * Define a class containing data members and methods to
+ * implement a read-only minimal perfect hash table using the
+ * CHD (compress, hash and displace) algorithm.
+ *
+ * Every bid id lands in exactly one slot of a dense bid array,
+ * so a search is one hash, one displacement lookup, one array
+ * access and one key compare - there are no chains to walk.
+ */
+class PerfectHashTable {
+
+private:
+    // displacement pair chosen for each bucket at build time
+    struct Displacement {
+        uint32_t d0;
+        uint32_t d1;
+
+        Displacement() {
+            d0 = 0;
+            d1 = 0;
+        }
+    };
+
+    // d0 and d1 are each tried below this bound for a bucket of two
+    // or more, so a bucket that will not fit fails fast and Build
+    // retries with smaller buckets
+    static const unsigned int MAX_DISPLACEMENT = 64;
+
+    vector<Displacement> displacements;
+    vector<Bid> bids;
+
+    unsigned int bucketCount = 0;
+
+    unsigned int bucket(uint64_t hash);
+    unsigned int slot(uint64_t hash, Displacement displacement);
+    bool tryBuild(vector<Bid>& uniqueBids, vector<uint64_t>& hashes);
+
+public:
+    PerfectHashTable();
+    bool Build(vector<Bid> allBids);
+    void PrintAll();
+    Bid Search(string bidId);
+    unsigned int Size();
+};
+
+/**
+ * Default constructor
+ */
+PerfectHashTable::PerfectHashTable() {
+    // nothing is stored until Build() is called
+}
+
+/**
+ * Select the bucket a hash belongs to
+ *
+ * @param hash The 64-bit hash of a bid id
+ * @return The bucket index
+ */
+unsigned int PerfectHashTable::bucket(uint64_t hash) {
+    return (unsigned int)(hash % bucketCount);
+}
+
+/**
+ * Calculate the final slot of a hash for a displacement pair.
+ * Two independent values are derived from the single hash so
+ * the string only ever has to be hashed once.
+ *
+ * @param hash The 64-bit hash of a bid id
+ * @param displacement The displacement pair of the hash's bucket
+ * @return The index into the dense bid array
+ */
+unsigned int PerfectHashTable::slot(uint64_t hash, Displacement displacement) {
+    uint64_t mixed = hash * 0x9E3779B97F4A7C15ULL;
+    uint64_t f1 = mixed >> 32;
+    uint64_t f2 = (mixed & 0xFFFFFFFFULL) | 1;
+    return (unsigned int)((f1 + displacement.d0 * f2 + displacement.d1) % bids.size());
+}
+
+/**
+ * Try to find a displacement pair for every bucket with the
+ * current bucket count
+ *
+ * @param uniqueBids The bids to place, one per bid id
+ * @param hashes The hash of each bid id in uniqueBids
+ * @return true if every bid found a free slot
+ */
+bool PerfectHashTable::tryBuild(vector<Bid>& uniqueBids, vector<uint64_t>& hashes) {
+    unsigned int count = uniqueBids.size();
+
+    // group the bids by bucket
+    vector<vector<unsigned int>> buckets(bucketCount);
+    for (unsigned int i = 0; i < count; ++i) {
+        buckets[bucket(hashes[i])].push_back(i);
+    }
+
+    // place the largest buckets first while the table is still empty
+    vector<unsigned int> order(bucketCount);
+    for (unsigned int i = 0; i < bucketCount; ++i) {
+        order[i] = i;
+    }
+    stable_sort(order.begin(), order.end(), [&buckets](unsigned int a, unsigned int b) {
+        return buckets[a].size() > buckets[b].size();
+    });
+
+    displacements.assign(bucketCount, Displacement());
+    vector<bool> taken(count, false);
+    vector<unsigned int> slots;
+    unsigned int nextFree = 0;
+    unsigned int limit = count < MAX_DISPLACEMENT ? count : MAX_DISPLACEMENT;
+
+    for (unsigned int b : order) {
+        vector<unsigned int>& members = buckets[b];
+        if (members.empty()) {
+            break;
+        }
+
+        bool placed = false;
+        Displacement displacement;
+        if (members.size() == 1) {
+            // a bucket of one goes straight to the next free slot: with
+            // d0 = 0 the slot is the undisplaced slot plus d1
+            while (taken[nextFree]) {
+                ++nextFree;
+            }
+            unsigned int start = slot(hashes[members[0]], Displacement());
+            displacement.d1 = (nextFree + count - start) % count;
+            slots.assign(1, nextFree);
+            placed = true;
+        }
+
+        // search a bounded set of displacement pairs until every
+        // member lands on a free slot
+        for (unsigned int d0 = 0; d0 < limit && !placed; ++d0) {
+            for (unsigned int d1 = 0; d1 < limit && !placed; ++d1) {
+                displacement.d0 = d0;
+                displacement.d1 = d1;
+                slots.clear();
+                for (unsigned int member : members) {
+                    unsigned int s = slot(hashes[member], displacement);
+                    if (taken[s] || find(slots.begin(), slots.end(), s) != slots.end()) {
+                        break;
+                    }
+                    slots.push_back(s);
+                }
+                placed = slots.size() == members.size();
+            }
+        }
+        if (!placed) {
+            return false;
+        }
+
+        displacements[b] = displacement;
+        for (unsigned int i = 0; i < members.size(); ++i) {
+            taken[slots[i]] = true;
+            bids[slots[i]] = uniqueBids[members[i]];
+        }
+    }
+    return true;
+}
+
+/**
+ * Build the table from a complete set of bids.
+ * When a bid id appears more than once the first bid wins,
+ * matching what HashTable::Search returns.
+ *
+ * @param allBids The bids to store
+ * @return true if the table was built
+ */
+bool PerfectHashTable::Build(vector<Bid> allBids) {
+    // drop repeated bid ids and hash every remaining id once
+    vector<Bid> uniqueBids;
+    vector<uint64_t> hashes;
+    unordered_set<string> seen;
+    for (auto const& bid : allBids) {
+        if (seen.insert(bid.bidId).second) {
+            uniqueBids.push_back(bid);
+            hashes.push_back(hashString(bid.bidId));
+        }
+    }
+    unsigned int kept = uniqueBids.size();
+
+    bids.assign(kept, Bid());
+    if (kept == 0) {
+        bucketCount = 0;
+        displacements.clear();
+        return true;
+    }
+
+    // start at an average of four bids per bucket and use more,
+    // smaller buckets if a displacement cannot be found
+    for (unsigned int load = 4; load > 0; --load) {
+        bucketCount = kept / load + 1;
+        if (tryBuild(uniqueBids, hashes)) {
+            return true;
+        }
+        bids.assign(kept, Bid());
+    }
+
+    bids.clear();
+    displacements.clear();
+    bucketCount = 0;
+    return false;
+}
+
+/**
+ * Print all bids in slot order
+ */
+void PerfectHashTable::PrintAll() {
+    BufferedWriter out;
+    for (unsigned int i = 0; i < bids.size(); ++i) {
+        out << "Slot " << i << ": " << bids[i].bidId << " | "
+            << bids[i].title << " | " << bids[i].amount << " | "
+            << bids[i].fund << '\n';
+    }
+}
+
+/**
+ * Search for the specified bidId
+ *
+ * @param bidId The bid id to search for
+ */
+Bid PerfectHashTable::Search(string bidId) {
+    // an empty table has no buckets to hash into
+    if (bids.empty()) {
+        return Bid();
+    }
+
+    // one hash selects the bucket and, with its displacement, the slot
+    uint64_t hash = hashString(bidId);
+    Bid& bid = bids[slot(hash, displacements[bucket(hash)])];
+
+    // ids that were never stored still land on some slot, so compare
+    if (bid.bidId.compare(bidId) == 0) {
+        return bid;
+    }
+    return Bid();
+}
+
+/**
+ * Returns the number of bids stored in the table
+ */
+unsigned int PerfectHashTable::Size() {
+    return bids.size();
+}
+
+//============================================================================
+// Hash table image file layout
+//============================================================================
+
+// A saved table is one relocatable file: a header, one entry index
+// per bucket, the chained entries of each bucket stored next to each
+// other, then a pool holding every string. Only offsets and indexes
+// are stored, so the file can be mapped at any address and queried
+// in place.
+
+const char IMAGE_MAGIC[8] = { 'B', 'I', 'D', 'H', 'A', 'S', 'H', '1' };
+const uint32_t IMAGE_VERSION = 1;
+const uint32_t IMAGE_NONE = UINT32_MAX;
+
+struct ImageHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t tableSize;
+    uint32_t entryCount;
+    uint32_t reserved;
+    uint64_t bucketOffset;
+    uint64_t entryOffset;
+    uint64_t stringOffset;
+    uint64_t fileSize;
+};
+
+struct ImageEntry {
+    uint64_t fingerprint;
+    uint32_t next;            // index of the next entry in the chain
+    uint32_t bidIdOffset;     // offsets are relative to the string pool
+    uint32_t bidIdLength;
+    uint32_t titleOffset;
+    uint32_t titleLength;
+    uint32_t fundOffset;
+    uint32_t fundLength;
+    uint32_t reserved;
+    double amount;
+};
+
 //============================================================================
 // Hash Table class definition
 //============================================================================
@@ -50,13 +359,18 @@ class HashTable {
 
 private:
     // Define structures to hold bids
+    // The fingerprint, key and next pointer come first so a chain
+    // walk only reads the front of each node; the bid payload is
+    // touched only once the full 64-bit fingerprints match.
     struct Node {
-        Bid bid;
+        uint64_t fingerprint;
         unsigned int key;
         Node *next;
+        Bid bid;
 
         // default constructor
         Node() {
+            fingerprint = 0;
             key = UINT_MAX;
             next = nullptr;
         }
@@ -64,6 +378,7 @@ private:
         // initialize with a bid
         Node(Bid aBid) : Node() {
             bid = aBid;
+            fingerprint = hashString(bid.bidId);
         }
 
         // initialize with a bid and a key
@@ -74,9 +389,25 @@ private:
 
     vector<Node> nodes;
 
+    // chained nodes come from the table's own slab pool
+    NodePool<Node> nodePool;
+
+    // optional secondary indexes holding the node of every bid
+    bool indexed = false;
+    unordered_map<string, unordered_set<Node*>> fundIndex;
+    multimap<double, Node*> amountIndex;
+
+    // optional Bloom filter answering most misses before any chain walk
+    bool filtered = false;
+    BloomFilter bloom;
+
     unsigned int tableSize = DEFAULT_SIZE;
 
     unsigned int hash(int key);
+    void indexNode(Node* node);
+    void unindexNode(Node* node);
+    void rebuildBloom();
+    void bloomRemoved();
 
 public:
     HashTable();
@@ -84,8 +415,17 @@ public:
     virtual ~HashTable();
     void Insert(Bid bid);
     void PrintAll();
+    void PrintAll(BufferedWriter& out);
     void Remove(string bidId);
     Bid Search(string bidId);
+    PerfectHashTable* Freeze();
+    NodePoolStats PoolStats();
+    void EnableIndexes();
+    vector<Bid> FindByFund(string fund);
+    vector<Bid> FindAmountRange(double low, double high);
+    bool SaveImage(string path);
+    void SetBloomFilter(bool enabled);
+    BloomFilterStats BloomStats();
 };
 
 /**
@@ -114,9 +454,17 @@ HashTable::HashTable(unsigned int size) {
  * Destructor
  */
 HashTable::~HashTable() {
-    // Implement logic to free storage when class is destroyed    
-    // erase nodes beginning
-    nodes.erase(nodes.begin());
+    // Implement logic to free storage when class is destroyed
+    // destroy every chained node; the pool then frees its slabs
+    // and the vector frees the bucket nodes
+    for (auto nodeSearch = nodes.begin(); nodeSearch != nodes.end(); ++nodeSearch) {
+        Node* node = nodeSearch->next;
+        while (node != nullptr) {
+            Node* next = node->next;
+            nodePool.Destroy(node);
+            node = next;
+        }
+    }
 }
 
 /**
@@ -145,29 +493,32 @@ void HashTable::Insert(Bid bid) {
     unsigned key = hash(atoi(bid.bidId.c_str()));
     // retrieve node using key
     Node* oldNode = &(nodes.at(key));
-    // if no entry found for the key
-    if (oldNode == nullptr) {
-        // assign this node to the key position
-        Node* newNode = new Node(bid, key);
-        nodes.insert(nodes.begin() + key, (*newNode));
+    // the bucket node always exists, so check whether it is used
+    // passing old node key to UNIT_MAX, set to key, set old node to bid and old node next to null pointer
+    if (oldNode->key == UINT_MAX) {
+        oldNode->key = key;
+        oldNode->bid = bid;
+        oldNode->fingerprint = hashString(bid.bidId);
+        oldNode->next = nullptr;
     }
 
-    // else if node is not used
+    // else find the next open node
     else {
-        // passing old node key to UNIT_MAX, set to key, set old node to bid and old node next to null pointer
-        if (oldNode->key == UINT_MAX) {
-            oldNode->key = key;
-            oldNode->bid = bid;
-            oldNode->next = nullptr;
+        while (oldNode->next != nullptr) {
+            oldNode = oldNode->next;
         }
+        // add new newNode to end
+        oldNode->next = nodePool.Create(bid, key);
+        oldNode = oldNode->next;
+    }
 
-        // else find the next open node
-        else {
-            while (oldNode->next != nullptr) {
-                oldNode = oldNode->next;
-            }
-            // add new newNode to end
-            oldNode->next = new Node(bid, key);
+    if (indexed) {
+        indexNode(oldNode);
+    }
+    if (filtered) {
+        bloom.Add(bid.bidId);
+        if (bloom.NeedsRebuild()) {
+            rebuildBloom();
         }
     }
 }
@@ -176,6 +527,16 @@ void HashTable::Insert(Bid bid) {
  * Print all bids
  */
 void HashTable::PrintAll() {
+    BufferedWriter out;
+    PrintAll(out);
+}
+
+/**
+ * Print all bids to a buffered writer
+ *
+ * @param out The writer for standard output, a pipe or a file
+ */
+void HashTable::PrintAll(BufferedWriter& out) {
     // FIXME (6): Implement logic to print all bids
     
     // for node begin to end iterate
@@ -183,36 +544,91 @@ void HashTable::PrintAll() {
         // if key not equal to UINT_MAX
         if (nodeSearch->key != UINT_MAX) {
             // output key, bidID, title, amount and fund
-            cout << "Key " << nodeSearch->key << ": " << nodeSearch->bid.bidId << " | "
+            out << "Key " << nodeSearch->key << ": " << nodeSearch->bid.bidId << " | "
                 << nodeSearch->bid.title << " | " << nodeSearch->bid.amount << " | "
-                << nodeSearch->bid.fund << endl;
+                << nodeSearch->bid.fund << '\n';
             // node is equal to next iter
             Node* node = nodeSearch->next;
             // while node not equal to nullptr
             while (node != nullptr) {
                 // output key, bidID, title, amount and fund
-                cout << " " << node->key << ": " << node->bid.bidId << " | " 
-                    << node->bid.title << " | " << node->bid.amount << " | " 
-                    << node->bid.fund << endl; node = node->next;
+                out << " " << node->key << ": " << node->bid.bidId << " | "
+                    << node->bid.title << " | " << node->bid.amount << " | "
+                    << node->bid.fund << '\n';
                 // node is equal to next node
-                Node* node = nodeSearch->next;
+                node = node->next;
             }
         }
-    }      
+    }
 }
 
- /**
+/**
  * Remove a bid
  *
  * @param bidId The bid id to search for
  */
 void HashTable::Remove(string bidId) {
     // Implement logic to remove a bid
-    Bid bid;
-    // set key equal to hash atoi bidID cstring
-    unsigned key = hash(atoi(bid.bidId.c_str()));
-    // erase node begin and key
-    nodes.erase(nodes.begin() + key);
+    // a bid the filter has never seen cannot be removed
+    if (filtered && !bloom.MayContain(bidId)) {
+        return;
+    }
+    // create the key and fingerprint for the given bid
+    unsigned key = hash(atoi(bidId.c_str()));
+    uint64_t fingerprint = hashString(bidId);
+    // retrieve the bucket node using the key
+    Node* node = &(nodes.at(key));
+
+    // if no entry found for the key there is nothing to remove
+    if (node->key == UINT_MAX) {
+        return;
+    }
+
+    // special case if the match lives in the bucket itself
+    if (node->fingerprint == fingerprint && node->bid.bidId.compare(bidId) == 0) {
+        Node* next = node->next;
+        if (indexed) {
+            unindexNode(node);
+        }
+        // pull the first chained node into the bucket
+        if (next != nullptr) {
+            // the moved bid is indexed under its new node
+            if (indexed) {
+                unindexNode(next);
+            }
+            node->fingerprint = next->fingerprint;
+            node->bid = next->bid;
+            node->next = next->next;
+            nodePool.Destroy(next);
+            if (indexed) {
+                indexNode(node);
+            }
+        }
+        // else the bucket becomes unused
+        else {
+            node->fingerprint = 0;
+            node->key = UINT_MAX;
+            node->bid = Bid();
+        }
+        bloomRemoved();
+        return;
+    }
+
+    // walk the chain comparing fingerprints before any bid id
+    while (node->next != nullptr) {
+        Node* next = node->next;
+        if (next->fingerprint == fingerprint && next->bid.bidId.compare(bidId) == 0) {
+            if (indexed) {
+                unindexNode(next);
+            }
+            // make current node point beyond the removed node
+            node->next = next->next;
+            nodePool.Destroy(next);
+            bloomRemoved();
+            return;
+        }
+        node = next;
+    }
 }
 
 /**
@@ -222,29 +638,27 @@ void HashTable::Remove(string bidId) {
  */
 Bid HashTable::Search(string bidId) {
     // Implement logic to search for and return a bid
-    Bid bid;    
-    // create the key for the given bid
+    Bid bid;
+    // most misses end here after touching one cache line
+    if (filtered && !bloom.MayContain(bidId)) {
+        return bid;
+    }
+    // create the key and fingerprint for the given bid
     unsigned key = hash(atoi(bidId.c_str()));
+    uint64_t fingerprint = hashString(bidId);
     // try to retrieve node using the key
     Node* node = &(nodes.at(key));
-    
+
     // if no entry found for the key
-    if (node == nullptr || node->key == UINT_MAX) {
+    if (node->key == UINT_MAX) {
         //return bid
         return bid;
     }
 
-    // if entry found for the key
-    if (node != nullptr && node->key != UINT_MAX
-        && node->bid.bidId.compare(bidId) == 0) {
-        //return node bid
-        return node->bid;
-    }
-        
     // while node not equal to nullptr
     while (node != nullptr) {
-        // if the current node matches, return it
-        if (node->key != UINT_MAX && node->bid.bidId.compare(bidId) == 0) {
+        // only compare bid ids once the fingerprints match
+        if (node->fingerprint == fingerprint && node->bid.bidId.compare(bidId) == 0) {
             return node->bid;
         }
         //node is equal to next node
@@ -254,103 +668,837 @@ Bid HashTable::Search(string bidId) {
     return bid;
 }
 
-//============================================================================
-// Static methods used for testing
-//============================================================================
+/**
+ * Returns the allocation statistics of the chained node pool
+ */
+NodePoolStats HashTable::PoolStats() {
+    return nodePool.Stats();
+}
 
 /**
- * Display the bid information to the console (std::out)
+ * Add a node to the secondary indexes
  *
- * @param bid struct containing the bid info
+ * @param node The node holding the bid to index
  */
-void displayBid(Bid bid) {
-    cout << bid.bidId << ": " << bid.title << " | " << bid.amount << " | "
-            << bid.fund << endl;
-    return;
+void HashTable::indexNode(Node* node) {
+    fundIndex[node->bid.fund].insert(node);
+    amountIndex.insert(make_pair(node->bid.amount, node));
 }
 
 /**
- * Load a CSV file containing bids into a container
+ * Remove a node from the secondary indexes
  *
- * @param csvPath the path to the CSV file to load
- * @return a container holding all the bids read
+ * @param node The node holding the bid to unindex
  */
-void loadBids(string csvPath, HashTable* hashTable) {
-    cout << "Loading CSV file " << csvPath << endl;
-
-    // initialize the CSV Parser using the given path
-    csv::Parser file = csv::Parser(csvPath);
-
-    // read and display header row - optional
-    vector<string> header = file.getHeader();
-    for (auto const& c : header) {
-        cout << c << " | ";
+void HashTable::unindexNode(Node* node) {
+    auto fund = fundIndex.find(node->bid.fund);
+    if (fund != fundIndex.end()) {
+        fund->second.erase(node);
+        // drop funds that no longer have any bids
+        if (fund->second.empty()) {
+            fundIndex.erase(fund);
+        }
     }
-    cout << "" << endl;
-
-    try {
-        // loop to read rows of a CSV file
-        for (unsigned int i = 0; i < file.rowCount(); i++) {
-
-            // Create a data structure and add to the collection of bids
-            Bid bid;
-            bid.bidId = file[i][1];
-            bid.title = file[i][0];
-            bid.fund = file[i][8];
-            bid.amount = strToDouble(file[i][4], '$');
 
-            // cout << "Item: " << bid.title << ", Fund: " << bid.fund << ", Amount: " << bid.amount << endl;
+    // only bids with exactly this amount need to be checked
+    auto range = amountIndex.equal_range(node->bid.amount);
+    for (auto entry = range.first; entry != range.second; ++entry) {
+        if (entry->second == node) {
+            amountIndex.erase(entry);
+            break;
+        }
+    }
+}
 
-            // push this bid to the end
-            hashTable->Insert(bid);
+/**
+ * Build the fund and amount indexes over the current contents
+ * and keep them up to date on every later insert and remove
+ */
+void HashTable::EnableIndexes() {
+    if (indexed) {
+        return;
+    }
+    indexed = true;
+    for (auto nodeSearch = nodes.begin(); nodeSearch != nodes.end(); ++nodeSearch) {
+        if (nodeSearch->key != UINT_MAX) {
+            for (Node* node = &(*nodeSearch); node != nullptr; node = node->next) {
+                indexNode(node);
+            }
         }
-    } catch (csv::Error &e) {
-        std::cerr << e.what() << std::endl;
     }
 }
 
 /**
- * Simple C function to convert a string to a double
- * after stripping out unwanted char
+ * Find every bid for a fund
  *
- * credit: http://stackoverflow.com/a/24875936
+ * @param fund The fund to search for
+ * @return the matching bids, empty if the indexes are disabled
+ */
+vector<Bid> HashTable::FindByFund(string fund) {
+    vector<Bid> bids;
+    auto found = fundIndex.find(fund);
+    if (found != fundIndex.end()) {
+        for (Node* node : found->second) {
+            bids.push_back(node->bid);
+        }
+    }
+    return bids;
+}
+
+/**
+ * Find every bid whose amount lies within a range
  *
- * @param ch The character to strip out
+ * @param low The smallest amount to include
+ * @param high The largest amount to include
+ * @return the matching bids in ascending amount order,
+ *         empty if the indexes are disabled
  */
-double strToDouble(string str, char ch) {
-    str.erase(remove(str.begin(), str.end(), ch), str.end());
-    return atof(str.c_str());
+vector<Bid> HashTable::FindAmountRange(double low, double high) {
+    vector<Bid> bids;
+    auto last = amountIndex.upper_bound(high);
+    for (auto entry = amountIndex.lower_bound(low); entry != last; ++entry) {
+        bids.push_back(entry->second->bid);
+    }
+    return bids;
 }
 
 /**
- * The one and only main() method
+ * Build a read-only perfect hash table holding every bid.
+ * The chained table is left untouched so it can keep
+ * serving inserts and removes.
+ *
+ * @return a new PerfectHashTable owned by the caller, or nullptr
+ *         if no perfect hash could be built
  */
-int main(int argc, char* argv[]) {
+PerfectHashTable* HashTable::Freeze() {
+    vector<Bid> bids;
+    // walk every bucket and its chain in table order
+    for (auto nodeSearch = nodes.begin(); nodeSearch != nodes.end(); ++nodeSearch) {
+        if (nodeSearch->key != UINT_MAX) {
+            for (Node* node = &(*nodeSearch); node != nullptr; node = node->next) {
+                bids.push_back(node->bid);
+            }
+        }
+    }
 
-    // process command line arguments
-    string csvPath, searchValue;
-    switch (argc) {
-    case 2:
-        csvPath = argv[1];
-        searchValue = "98011";
-        break;  
-    case 3:
-        csvPath = argv[1];
-        searchValue = argv[2];
-        break;
-    default:
-        csvPath = "eBid_Monthly_Sales.csv";
-        searchValue = "98011";
+    PerfectHashTable* frozen = new PerfectHashTable();
+    if (!frozen->Build(bids)) {
+        delete frozen;
+        return nullptr;
     }
+    return frozen;
+}
 
-    // Define a timer variable
-    clock_t ticks;
+/**
+ * Refill the Bloom filter from the current contents, sized
+ * for twice the current number of bids
+ */
+void HashTable::rebuildBloom() {
+    unsigned int count = 0;
+    for (auto nodeSearch = nodes.begin(); nodeSearch != nodes.end(); ++nodeSearch) {
+        if (nodeSearch->key != UINT_MAX) {
+            for (Node* node = &(*nodeSearch); node != nullptr; node = node->next) {
+                ++count;
+            }
+        }
+    }
+    bloom.Clear(count * 2);
+    for (auto nodeSearch = nodes.begin(); nodeSearch != nodes.end(); ++nodeSearch) {
+        if (nodeSearch->key != UINT_MAX) {
+            for (Node* node = &(*nodeSearch); node != nullptr; node = node->next) {
+                bloom.Add(node->bid.bidId);
+            }
+        }
+    }
+}
 
-    // Define a hash table to hold all the bids
+/**
+ * Record a removed bid in the Bloom filter, rebuilding it
+ * once too many of its keys are stale
+ */
+void HashTable::bloomRemoved() {
+    if (filtered) {
+        bloom.Removed();
+        if (bloom.NeedsRebuild()) {
+            rebuildBloom();
+        }
+    }
+}
+
+/**
+ * Turn the Bloom filter in front of Search and Remove on or off
+ *
+ * @param enabled true to build the filter over the current contents
+ */
+void HashTable::SetBloomFilter(bool enabled) {
+    if (enabled && !filtered) {
+        rebuildBloom();
+    }
+    filtered = enabled;
+}
+
+/**
+ * Returns the size and hit statistics of the Bloom filter
+ */
+BloomFilterStats HashTable::BloomStats() {
+    return bloom.Stats();
+}
+
+/**
+ * Write the table to a relocatable image file that
+ * HashTableImage can map and query without rebuilding
+ *
+ * @param path The path of the image file to write
+ * @return true if the whole image was written
+ */
+bool HashTable::SaveImage(string path) {
+    vector<uint32_t> buckets(tableSize, IMAGE_NONE);
+    vector<ImageEntry> entries;
+    string pool;
+
+    // flatten each chain into consecutive entries
+    for (unsigned int b = 0; b < tableSize; ++b) {
+        if (nodes[b].key == UINT_MAX) {
+            continue;
+        }
+        buckets[b] = entries.size();
+        for (Node* node = &nodes[b]; node != nullptr; node = node->next) {
+            ImageEntry entry = ImageEntry();
+            entry.fingerprint = node->fingerprint;
+            entry.next = node->next != nullptr ? entries.size() + 1 : IMAGE_NONE;
+            entry.bidIdOffset = pool.size();
+            entry.bidIdLength = node->bid.bidId.size();
+            pool += node->bid.bidId;
+            entry.titleOffset = pool.size();
+            entry.titleLength = node->bid.title.size();
+            pool += node->bid.title;
+            entry.fundOffset = pool.size();
+            entry.fundLength = node->bid.fund.size();
+            pool += node->bid.fund;
+            entry.amount = node->bid.amount;
+            entries.push_back(entry);
+        }
+    }
+
+    // offsets and indexes are stored in 32 bits, so a pool past
+    // 4 GB or more entries than an index can name cannot be saved
+    if (pool.size() > UINT32_MAX || entries.size() >= IMAGE_NONE) {
+        return false;
+    }
+
+    // lay the sections out on 8-byte boundaries
+    ImageHeader header = ImageHeader();
+    memcpy(header.magic, IMAGE_MAGIC, sizeof(header.magic));
+    header.version = IMAGE_VERSION;
+    header.tableSize = tableSize;
+    header.entryCount = entries.size();
+    header.bucketOffset = sizeof(ImageHeader);
+    header.entryOffset = (header.bucketOffset + buckets.size() * sizeof(uint32_t) + 7) & ~7ULL;
+    header.stringOffset = header.entryOffset + entries.size() * sizeof(ImageEntry);
+    header.fileSize = header.stringOffset + pool.size();
+
+    ofstream file(path, ios::binary | ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+    file.write((const char*)&header, sizeof(header));
+    file.write((const char*)buckets.data(), buckets.size() * sizeof(uint32_t));
+    const char padding[8] = { 0 };
+    file.write(padding, header.entryOffset - header.bucketOffset - buckets.size() * sizeof(uint32_t));
+    file.write((const char*)entries.data(), entries.size() * sizeof(ImageEntry));
+    file.write(pool.data(), pool.size());
+    return file.good();
+}
+
+//============================================================================
+// Hash Table Image class definition
+//============================================================================
+
+/**
+ * Define a class that maps a saved hash table image read-only
+ * and searches it in place. Nothing is deserialized, and every
+ * process mapping the same file shares its page cache copy.
+ */
+class HashTableImage {
+
+private:
+    const char* base = nullptr;
+    size_t length = 0;
+    const ImageHeader* header = nullptr;
+    const uint32_t* buckets = nullptr;
+    const ImageEntry* entries = nullptr;
+    const char* strings = nullptr;
+
+#ifdef _WIN32
+    HANDLE fileHandle = INVALID_HANDLE_VALUE;
+    HANDLE mappingHandle = NULL;
+#endif
+
+    bool validate();
+    const ImageEntry* entryAt(uint32_t index);
+    Bid toBid(const ImageEntry& entry);
+
+public:
+    HashTableImage();
+    virtual ~HashTableImage();
+    bool Open(string path);
+    void Close();
+    void PrintAll();
+    Bid Search(string bidId);
+    unsigned int Size();
+};
+
+/**
+ * Default constructor
+ */
+HashTableImage::HashTableImage() {
+    // nothing is mapped until Open() is called
+}
+
+/**
+ * Destructor
+ */
+HashTableImage::~HashTableImage() {
+    Close();
+}
+
+/**
+ * Map an image file read-only
+ *
+ * @param path The path of an image written by HashTable::SaveImage
+ * @return true if the file was mapped and is a valid image
+ */
+bool HashTableImage::Open(string path) {
+    Close();
+
+#ifdef _WIN32
+    fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0) {
+        Close();
+        return false;
+    }
+    mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mappingHandle == NULL) {
+        Close();
+        return false;
+    }
+    base = (const char*)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    length = (size_t)fileSize.QuadPart;
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    // a shared mapping lets every process use the same cached pages
+    void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+    base = (const char*)mapped;
+    length = info.st_size;
+#endif
+
+    if (base == nullptr || !validate()) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Unmap the image, if one is open
+ */
+void HashTableImage::Close() {
+#ifdef _WIN32
+    if (base != nullptr) {
+        UnmapViewOfFile(base);
+    }
+    if (mappingHandle != NULL) {
+        CloseHandle(mappingHandle);
+        mappingHandle = NULL;
+    }
+    if (fileHandle != INVALID_HANDLE_VALUE) {
+        CloseHandle(fileHandle);
+        fileHandle = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (base != nullptr) {
+        munmap((void*)base, length);
+    }
+#endif
+    base = nullptr;
+    length = 0;
+    header = nullptr;
+    buckets = nullptr;
+    entries = nullptr;
+    strings = nullptr;
+}
+
+/**
+ * Check the header and section bounds of the mapped file
+ * so a truncated or foreign file is never read past its end.
+ * Entries are checked one at a time as they are read, so
+ * opening a large image does not touch every page.
+ *
+ * @return true if the mapping holds a complete image
+ */
+bool HashTableImage::validate() {
+    if (length < sizeof(ImageHeader)) {
+        return false;
+    }
+    header = (const ImageHeader*)base;
+    if (memcmp(header->magic, IMAGE_MAGIC, sizeof(IMAGE_MAGIC)) != 0
+        || header->version != IMAGE_VERSION
+        || header->tableSize == 0
+        || header->fileSize != length) {
+        return false;
+    }
+    // the sections must follow the header in order, each aligned
+    // for its type; comparing before subtracting means no size
+    // computed from a corrupt offset can wrap around
+    if (header->bucketOffset < sizeof(ImageHeader)
+        || header->bucketOffset > header->entryOffset
+        || header->entryOffset > header->stringOffset
+        || header->stringOffset > length
+        || header->bucketOffset % sizeof(uint32_t) != 0
+        || header->entryOffset % 8 != 0
+        || (uint64_t)header->tableSize * sizeof(uint32_t) > header->entryOffset - header->bucketOffset
+        || (uint64_t)header->entryCount * sizeof(ImageEntry) != header->stringOffset - header->entryOffset) {
+        return false;
+    }
+    buckets = (const uint32_t*)(base + header->bucketOffset);
+    entries = (const ImageEntry*)(base + header->entryOffset);
+    strings = base + header->stringOffset;
+    return true;
+}
+
+/**
+ * Look up an entry and check that its strings stay inside the file
+ *
+ * @param index The index of the entry, from a bucket or a next link
+ * @return the entry, or nullptr at the end of a chain or if it is damaged
+ */
+const ImageEntry* HashTableImage::entryAt(uint32_t index) {
+    if (index >= header->entryCount) {
+        return nullptr;
+    }
+    const ImageEntry* entry = &entries[index];
+    uint64_t poolSize = length - header->stringOffset;
+    if ((uint64_t)entry->bidIdOffset + entry->bidIdLength > poolSize
+        || (uint64_t)entry->titleOffset + entry->titleLength > poolSize
+        || (uint64_t)entry->fundOffset + entry->fundLength > poolSize) {
+        return nullptr;
+    }
+    return entry;
+}
+
+/**
+ * Copy a mapped entry out into a bid
+ *
+ * @param entry The entry to copy
+ * @return a bid holding the entry's fields
+ */
+Bid HashTableImage::toBid(const ImageEntry& entry) {
+    Bid bid;
+    bid.bidId.assign(strings + entry.bidIdOffset, entry.bidIdLength);
+    bid.title.assign(strings + entry.titleOffset, entry.titleLength);
+    bid.fund.assign(strings + entry.fundOffset, entry.fundLength);
+    bid.amount = entry.amount;
+    return bid;
+}
+
+/**
+ * Print all bids in bucket order, like HashTable::PrintAll
+ */
+void HashTableImage::PrintAll() {
+    if (header == nullptr) {
+        return;
+    }
+    BufferedWriter out;
+    for (uint32_t b = 0; b < header->tableSize; ++b) {
+        // a chain never has more links than the image has entries,
+        // so a damaged next cycle stops instead of looping
+        const ImageEntry* entry = entryAt(buckets[b]);
+        for (uint32_t steps = 0; entry != nullptr && steps < header->entryCount; ++steps) {
+            Bid bid = toBid(*entry);
+            if (steps == 0) {
+                out << "Key " << b << ": ";
+            } else {
+                out << " " << b << ": ";
+            }
+            out << bid.bidId << " | " << bid.title << " | "
+                << bid.amount << " | " << bid.fund << '\n';
+            entry = entryAt(entry->next);
+        }
+    }
+}
+
+/**
+ * Search for the specified bidId
+ *
+ * @param bidId The bid id to search for
+ */
+Bid HashTableImage::Search(string bidId) {
+    if (header == nullptr) {
+        return Bid();
+    }
+
+    // same bucket and fingerprint as the table that wrote the image
+    unsigned int key = (unsigned int)atoi(bidId.c_str()) % header->tableSize;
+    uint64_t fingerprint = hashString(bidId);
+
+    const ImageEntry* entry = entryAt(buckets[key]);
+    for (uint32_t steps = 0; entry != nullptr && steps < header->entryCount; ++steps) {
+        if (entry->fingerprint == fingerprint && entry->bidIdLength == bidId.size()
+            && memcmp(strings + entry->bidIdOffset, bidId.data(), bidId.size()) == 0) {
+            return toBid(*entry);
+        }
+        entry = entryAt(entry->next);
+    }
+    return Bid();
+}
+
+/**
+ * Returns the number of bids in the image
+ */
+unsigned int HashTableImage::Size() {
+    return header == nullptr ? 0 : header->entryCount;
+}
+
+//============================================================================
+// Static methods used for testing
+//============================================================================
+
+/**
+ * Display the bid information to the console (std::out)
+ *
+ * @param bid struct containing the bid info
+ */
+void displayBid(Bid bid) {
+    cout << bid.bidId << ": " << bid.title << " | " << bid.amount << " | "
+            << bid.fund << endl;
+    return;
+}
+
+/**
+ * Find the column holding each bid's fund. The full export keeps
+ * it in column 19, the December 2016 file in column 8.
+ *
+ * @param file the parsed CSV file
+ * @return the index of the Fund column
+ */
+unsigned int fundColumn(csv::Parser& file) {
+    vector<string> header = file.getHeader();
+    for (unsigned int i = 0; i < header.size(); ++i) {
+        string name = header[i];
+        name.erase(remove_if(name.begin(), name.end(), ::isspace), name.end());
+        if (name == "Fund") {
+            return i;
+        }
+    }
+    return 8;
+}
+
+/**
+ * Load a CSV file containing bids into a container
+ *
+ * @param csvPath the path to the CSV file to load
+ * @return a container holding all the bids read
+ */
+void loadBids(string csvPath, HashTable* hashTable) {
+    cout << "Loading CSV file " << csvPath << endl;
+
+    // initialize the CSV Parser using the given path
+    csv::Parser file = csv::Parser(csvPath);
+
+    // the fund column differs between the monthly export files
+    unsigned int fund = fundColumn(file);
+
+    // read and display header row - optional
+    vector<string> header = file.getHeader();
+    for (auto const& c : header) {
+        cout << c << " | ";
+    }
+    cout << "" << endl;
+
+    try {
+        // loop to read rows of a CSV file
+        for (unsigned int i = 0; i < file.rowCount(); i++) {
+
+            // Create a data structure and add to the collection of bids
+            Bid bid;
+            bid.bidId = file[i][1];
+            bid.title = file[i][0];
+            bid.fund = file[i][fund];
+            bid.amount = strToDouble(file[i][4], '$');
+
+            // cout << "Item: " << bid.title << ", Fund: " << bid.fund << ", Amount: " << bid.amount << endl;
+
+            // push this bid to the end
+            hashTable->Insert(bid);
+        }
+    } catch (csv::Error &e) {
+        std::cerr << e.what() << std::endl;
+    }
+}
+
+/**
+ * Display the allocation statistics of a node pool
+ *
+ * @param stats statistics reported by the pool
+ */
+void displayPoolStats(NodePoolStats stats) {
+    cout << "slabs: " << stats.slabs << " (" << stats.bytes << " bytes)" << endl;
+    cout << "nodes: " << stats.live << " live of " << stats.capacity << " capacity" << endl;
+    cout << "allocations: " << stats.allocations << " (" << stats.reuses
+        << " from free list)" << endl;
+}
+
+/**
+ * Load a CSV file containing bids into a vector
+ *
+ * @param csvPath the path to the CSV file to load
+ * @return a vector holding all the bids read
+ */
+vector<Bid> readBids(string csvPath) {
+    vector<Bid> bids;
+
+    // initialize the CSV Parser using the given path
+    csv::Parser file = csv::Parser(csvPath);
+    unsigned int fund = fundColumn(file);
+
+    try {
+        // loop to read rows of a CSV file
+        for (unsigned int i = 0; i < file.rowCount(); i++) {
+            Bid bid;
+            bid.bidId = file[i][1];
+            bid.title = file[i][0];
+            bid.fund = file[i][fund];
+            bid.amount = strToDouble(file[i][4], '$');
+            bids.push_back(bid);
+        }
+    } catch (csv::Error &e) {
+        std::cerr << e.what() << std::endl;
+    }
+    return bids;
+}
+
+/**
+ * Create a synthetic bid for benchmarks larger than the CSV files
+ *
+ * @param n Sequence number used as the bid id
+ * @return a bid with the given id
+ */
+Bid makeBid(unsigned int n) {
+    Bid bid;
+    bid.bidId = to_string(n);
+    bid.title = "Synthetic Bid " + bid.bidId;
+    bid.fund = (n % 2 == 0) ? "General Fund" : "Enterprise";
+    bid.amount = (n % 100000) / 100.0;
+    return bid;
+}
+
+/**
+ * Compare build and lookup times of the chained hash table
+ * against the frozen perfect hash table
+ *
+ * @param bids The bids to load into both tables
+ */
+void benchmarkFrozen(vector<Bid>& bids) {
+    clock_t ticks;
+    cout << bids.size() << " bids" << endl;
+
+    // build both tables from the same data
+    ticks = clock();
+    HashTable* chained = new HashTable();
+    for (auto const& bid : bids) {
+        chained->Insert(bid);
+    }
+    ticks = clock() - ticks;
+    cout << "chained build: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+
+    ticks = clock();
+    PerfectHashTable* frozen = new PerfectHashTable();
+    bool built = frozen->Build(bids);
+    ticks = clock() - ticks;
+    if (!built) {
+        cout << "perfect build failed after " << ticks * 1.0 / CLOCKS_PER_SEC
+            << " seconds; only the chained table is measured" << endl;
+    } else {
+        cout << "perfect build: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+    }
+
+    // look every id up in shuffled order, repeating small sets
+    // so both tables run at least a million searches
+    vector<string> ids;
+    for (auto const& bid : bids) {
+        ids.push_back(bid.bidId);
+    }
+    shuffle(ids.begin(), ids.end(), mt19937(1));
+    unsigned int rounds = ids.empty() ? 0 : 1000000 / ids.size() + 1;
+    unsigned int found = 0;
+
+    ticks = clock();
+    for (unsigned int r = 0; r < rounds; ++r) {
+        for (auto const& id : ids) {
+            found += chained->Search(id).bidId.empty() ? 0 : 1;
+        }
+    }
+    ticks = clock() - ticks;
+    cout << "chained search: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds for "
+        << rounds * ids.size() << " searches (" << found << " found)" << endl;
+
+    if (!built) {
+        delete chained;
+        delete frozen;
+        return;
+    }
+    found = 0;
+    ticks = clock();
+    for (unsigned int r = 0; r < rounds; ++r) {
+        for (auto const& id : ids) {
+            found += frozen->Search(id).bidId.empty() ? 0 : 1;
+        }
+    }
+    ticks = clock() - ticks;
+    cout << "perfect search: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds for "
+        << rounds * ids.size() << " searches (" << found << " found)" << endl;
+
+    delete chained;
+    delete frozen;
+}
+
+/**
+ * Measure the false positive rate of the Bloom filter and what
+ * it saves on bucket chain walks for bids that do not exist
+ *
+ * @param hashTable The loaded table to search
+ * @param misses Number of missing bid ids to search for
+ */
+void benchmarkBloom(HashTable* hashTable, unsigned int misses) {
+    clock_t ticks;
+    unsigned int found = 0;
+
+    // atoi stops at the x, so each missing id still picks an
+    // ordinary bucket and an unfiltered miss walks its chain
+    vector<string> ids;
+    for (unsigned int i = 0; i < misses; ++i) {
+        ids.push_back(to_string(i) + "x");
+    }
+
+    hashTable->SetBloomFilter(false);
+    ticks = clock();
+    for (auto const& id : ids) {
+        found += hashTable->Search(id).bidId.empty() ? 0 : 1;
+    }
+    ticks = clock() - ticks;
+    cout << "without filter: " << ticks * 1.0e9 / CLOCKS_PER_SEC / max(misses, 1u)
+        << " nanoseconds per miss" << endl;
+
+    hashTable->SetBloomFilter(true);
+    BloomFilterStats before = hashTable->BloomStats();
+    ticks = clock();
+    for (auto const& id : ids) {
+        found += hashTable->Search(id).bidId.empty() ? 0 : 1;
+    }
+    ticks = clock() - ticks;
+    BloomFilterStats after = hashTable->BloomStats();
+    cout << "with filter: " << ticks * 1.0e9 / CLOCKS_PER_SEC / max(misses, 1u)
+        << " nanoseconds per miss" << endl;
+
+    size_t queries = after.queries - before.queries;
+    size_t positives = after.positives - before.positives;
+    cout << "false positive rate: " << (queries == 0 ? 0.0 : positives * 100.0 / queries)
+        << "% (" << positives << " of " << queries << ")" << endl;
+    cout << "filter: " << after.keys << " keys in " << after.bytes << " bytes" << endl;
+    cout << found << " unexpected hits" << endl;
+}
+
+/**
+ * Simple C function to convert a string to a double
+ * after stripping out unwanted char
+ *
+ * credit: http://stackoverflow.com/a/24875936
+ *
+ * @param ch The character to strip out
+ */
+double strToDouble(string str, char ch) {
+    str.erase(remove(str.begin(), str.end(), ch), str.end());
+    return atof(str.c_str());
+}
+
+/**
+ * Calculate a 64-bit hash of a string using FNV-1a followed
+ * by a finalizing mix so both halves of the result are usable
+ *
+ * @param str The string to hash
+ * @return The calculated hash
+ */
+uint64_t hashString(const string& str) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : str) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+/**
+ * The one and only main() method
+ */
+int main(int argc, char* argv[]) {
+
+    // process command line arguments
+    string csvPath, searchValue;
+    switch (argc) {
+    case 2:
+        csvPath = argv[1];
+        searchValue = "98011";
+        break;  
+    case 3:
+        csvPath = argv[1];
+        searchValue = argv[2];
+        break;
+    default:
+        csvPath = "eBid_Monthly_Sales.csv";
+        searchValue = "98011";
+    }
+
+    // Define a timer variable
+    clock_t ticks;
+
+    // Define a hash table to hold all the bids
     HashTable* bidTable;
 
+    // Define a frozen copy of the table once it is read-only
+    PerfectHashTable* frozenTable = nullptr;
+    vector<Bid> bids;
+    unsigned int count = 0;
+
     Bid bid;
     bidTable = new HashTable();
+    bidTable->EnableIndexes();
+    bidTable->SetBloomFilter(true);
+
+    // Define a mapped table image and where it is saved
+    HashTableImage* tableImage = new HashTableImage();
+    string imagePath = csvPath + ".img";
+    string fund;
+    double low, high;
     
     int choice = 0;
     while (choice != 9) {
@@ -359,6 +1507,16 @@ int main(int argc, char* argv[]) {
         cout << "  2. Display All Bids" << endl;
         cout << "  3. Find Bid" << endl;
         cout << "  4. Remove Bid" << endl;
+        cout << "  5. Freeze Table" << endl;
+        cout << "  6. Find Bid in Frozen Table" << endl;
+        cout << "  7. Benchmark Frozen Table" << endl;
+        cout << "  8. Show Node Pool Statistics" << endl;
+        cout << "  10. Find Bids by Fund" << endl;
+        cout << "  11. Find Bids by Amount Range" << endl;
+        cout << "  12. Save Table Image" << endl;
+        cout << "  13. Open Table Image" << endl;
+        cout << "  14. Find Bid in Table Image" << endl;
+        cout << "  15. Benchmark Bloom Filter" << endl;
         cout << "  9. Exit" << endl;
         cout << "Enter choice: ";
         cin >> choice;
@@ -403,10 +1561,161 @@ int main(int argc, char* argv[]) {
         case 4:
             bidTable->Remove(searchValue);
             break;
+
+        case 5:
+            ticks = clock();
+
+            // replace any earlier snapshot with the current contents
+            delete frozenTable;
+            frozenTable = bidTable->Freeze();
+
+            ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+            if (frozenTable == nullptr) {
+                cout << "Could not build a perfect hash table; searches use the chained table" << endl;
+            } else {
+                cout << frozenTable->Size() << " bids frozen" << endl;
+            }
+            cout << "time: " << ticks << " clock ticks" << endl;
+            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+            break;
+
+        case 6:
+            if (frozenTable == nullptr) {
+                cout << "No frozen table - searching the chained table (freeze with option 5)" << endl;
+            }
+
+            ticks = clock();
+
+            bid = frozenTable != nullptr ? frozenTable->Search(searchValue)
+                                         : bidTable->Search(searchValue);
+
+            ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+
+            if (!bid.bidId.empty()) {
+                displayBid(bid);
+            } else {
+                cout << "Bid Id " << searchValue << " not found." << endl;
+            }
+
+            cout << "time: " << ticks << " clock ticks" << endl;
+            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+            break;
+
+        case 7:
+            // 0 benchmarks the CSV file, anything else synthetic bids
+            cout << "Number of bids (0 for CSV file): ";
+            cin >> count;
+            if (count == 0) {
+                bids = readBids(csvPath);
+            } else {
+                bids.clear();
+                for (unsigned int i = 0; i < count; ++i) {
+                    bids.push_back(makeBid(i));
+                }
+            }
+            benchmarkFrozen(bids);
+            bids.clear();
+            break;
+
+        case 8:
+            displayPoolStats(bidTable->PoolStats());
+            break;
+
+        case 10:
+            cout << "Enter fund: ";
+            cin.ignore();
+            getline(cin, fund);
+
+            ticks = clock();
+            bids = bidTable->FindByFund(fund);
+            ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+
+            for (auto const& found : bids) {
+                displayBid(found);
+            }
+            cout << bids.size() << " bids found" << endl;
+            cout << "time: " << ticks << " clock ticks" << endl;
+            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+            bids.clear();
+            break;
+
+        case 11:
+            cout << "Enter lowest amount: ";
+            cin >> low;
+            cout << "Enter highest amount: ";
+            cin >> high;
+
+            ticks = clock();
+            bids = bidTable->FindAmountRange(low, high);
+            ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+
+            for (auto const& found : bids) {
+                displayBid(found);
+            }
+            cout << bids.size() << " bids found" << endl;
+            cout << "time: " << ticks << " clock ticks" << endl;
+            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+            bids.clear();
+            break;
+
+        case 12:
+            ticks = clock();
+
+            if (bidTable->SaveImage(imagePath)) {
+                cout << "Saved table image " << imagePath << endl;
+            } else {
+                cout << "Could not write " << imagePath << endl;
+            }
+
+            ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+            cout << "time: " << ticks << " clock ticks" << endl;
+            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+            break;
+
+        case 13:
+            ticks = clock();
+
+            if (tableImage->Open(imagePath)) {
+                cout << tableImage->Size() << " bids mapped from " << imagePath << endl;
+            } else {
+                cout << imagePath << " is missing or not a table image" << endl;
+            }
+
+            ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+            cout << "time: " << ticks << " clock ticks" << endl;
+            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+            break;
+
+        case 14:
+            ticks = clock();
+
+            bid = tableImage->Search(searchValue);
+
+            ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+
+            if (!bid.bidId.empty()) {
+                displayBid(bid);
+            } else {
+                cout << "Bid Id " << searchValue << " not found." << endl;
+            }
+
+            cout << "time: " << ticks << " clock ticks" << endl;
+            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+            break;
+
+        case 15:
+            cout << "Number of missing bids to search for: ";
+            cin >> count;
+            benchmarkBloom(bidTable, count);
+            break;
         }
     }
 
     cout << "Good bye." << endl;
 
+    delete tableImage;
+    delete frozenTable;
+    delete bidTable;
+
     return 0;
 }
@@ -0,0 +1,127 @@
+#ifndef     _NODEPOOL_HPP_
+# define    _NODEPOOL_HPP_
+
+# include <cstddef>
+# include <new>
+# include <type_traits>
+# include <utility>
+# include <vector>
+
+/**
+ * Statistics reported by a NodePool
+ */
+struct NodePoolStats
+{
+    size_t slabs;       // slabs requested from the global allocator
+    size_t capacity;    // nodes that fit in all slabs
+    size_t live;        // nodes currently handed out
+    size_t allocations; // total Create calls
+    size_t reuses;      // Create calls served from the free list
+    size_t bytes;       // bytes held in slabs
+};
+
+/**
+ * Slab allocator for the fixed-size nodes of a single container.
+ *
+ * Nodes are carved out of large slabs by bumping a cursor, and
+ * destroyed nodes go on a free list that the next Create pops.
+ * Each container owns its own pool, so free lists are never
+ * shared. Slabs are only returned when the pool is destroyed,
+ * which costs one delete per slab rather than one per node;
+ * the owning container still destroys its live nodes first so
+ * their payloads release anything they hold.
+ */
+template <typename T>
+class NodePool
+{
+    private:
+        // a free slot reuses the node's own storage as the link
+        union Slot
+        {
+            Slot *nextFree;
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+        };
+
+        static const size_t FIRST_SLAB = 64;
+        static const size_t MAX_SLAB = 4096;
+
+        std::vector<Slot *> _slabs;
+        Slot *_cursor;
+        Slot *_limit;
+        Slot *_freeList;
+        size_t _nextSlab;
+        NodePoolStats _stats;
+
+        // request a new slab, doubling the size up to MAX_SLAB nodes
+        void grow(void)
+        {
+            Slot *slab = static_cast<Slot *>(::operator new(_nextSlab * sizeof(Slot)));
+            _slabs.push_back(slab);
+            _cursor = slab;
+            _limit = slab + _nextSlab;
+            _stats.slabs++;
+            _stats.capacity += _nextSlab;
+            _stats.bytes += _nextSlab * sizeof(Slot);
+            if (_nextSlab < MAX_SLAB)
+                _nextSlab *= 2;
+        }
+
+    public:
+        NodePool(void) :
+            _cursor(nullptr), _limit(nullptr), _freeList(nullptr), _nextSlab(FIRST_SLAB)
+        {
+            _stats = NodePoolStats();
+        }
+
+        ~NodePool(void)
+        {
+            for (Slot *slab : _slabs)
+                ::operator delete(slab);
+        }
+
+        NodePool(const NodePool &) = delete;
+        NodePool &operator=(const NodePool &) = delete;
+
+        /**
+         * Construct a node, reusing a freed slot when one exists
+         */
+        template <typename... Args>
+        T *Create(Args &&... args)
+        {
+            Slot *slot;
+            if (_freeList != nullptr)
+            {
+                slot = _freeList;
+                _freeList = slot->nextFree;
+                _stats.reuses++;
+            }
+            else
+            {
+                if (_cursor == _limit)
+                    grow();
+                slot = _cursor++;
+            }
+            _stats.allocations++;
+            _stats.live++;
+            return new (&slot->storage) T(std::forward<Args>(args)...);
+        }
+
+        /**
+         * Destroy a node and put its slot on the free list
+         */
+        void Destroy(T *node)
+        {
+            node->~T();
+            Slot *slot = reinterpret_cast<Slot *>(node);
+            slot->nextFree = _freeList;
+            _freeList = slot;
+            _stats.live--;
+        }
+
+        const NodePoolStats &Stats(void) const
+        {
+            return _stats;
+        }
+};
+
+#endif /*!_NODEPOOL_HPP_*/
@@ -0,0 +1,204 @@
+#ifndef     _EPOCHDOMAIN_HPP_
+# define    _EPOCHDOMAIN_HPP_
+
+# include <atomic>
+# include <cstddef>
+# include <cstdint>
+# include <functional>
+# include <thread>
+
+/**
+ * Statistics reported by an EpochDomain
+ */
+struct EpochStats
+{
+    uint64_t epoch;     // current global epoch
+    size_t retired;     // nodes handed to Retire
+    size_t reclaimed;   // retired nodes deleted so far
+    size_t pending;     // retired nodes still waiting for their grace period
+};
+
+/**
+ * Epoch-based reclamation for the nodes of one lock-free container.
+ *
+ * Every operation on the container holds a Guard, which announces
+ * the global epoch in one of a fixed set of slots for as long as
+ * the operation runs. A node unlinked from the container is handed
+ * to Retire, stamped with the epoch of the moment, and deleted only
+ * once the global epoch has moved the grace number of epochs past
+ * that stamp. The epoch only advances when every announced slot has
+ * caught up with it, so no operation that could still hold the
+ * node is running by then.
+ *
+ * The domain serves up to SLOTS operations at once; a further
+ * operation waits for a slot to come free.
+ */
+template <typename T>
+class EpochDomain
+{
+    private:
+        static const size_t SLOTS = 64;
+        static const size_t RECLAIM_INTERVAL = 64;
+
+        // one announcement per cache line so guards do not share lines
+        struct Slot
+        {
+            std::atomic<uint64_t> epoch;
+            char padding[64 - sizeof(std::atomic<uint64_t>)];
+        };
+
+        struct Retired
+        {
+            T *node;
+            uint64_t epoch;
+            Retired *next;
+        };
+
+        Slot _slots[SLOTS];
+        std::atomic<uint64_t> _epoch;
+        std::atomic<Retired *> _retired;
+        std::atomic<size_t> _retireCount;
+        std::atomic<size_t> _reclaimed;
+        std::atomic<size_t> _pending;
+        uint64_t _grace;
+
+        void push(Retired *entry)
+        {
+            entry->next = _retired.load();
+            while (!_retired.compare_exchange_weak(entry->next, entry))
+                ;
+        }
+
+        // move the epoch on if every running operation has seen it
+        void tryAdvance(void)
+        {
+            uint64_t epoch = _epoch.load();
+            for (size_t i = 0; i < SLOTS; ++i)
+            {
+                uint64_t announced = _slots[i].epoch.load();
+                if (announced != 0 && announced != epoch)
+                    return;
+            }
+            _epoch.compare_exchange_strong(epoch, epoch + 1);
+        }
+
+    public:
+        /**
+         * Announces the caller for the lifetime of the guard
+         */
+        class Guard
+        {
+            private:
+                EpochDomain &_domain;
+                size_t _slot;
+
+            public:
+                Guard(EpochDomain &domain) : _domain(domain)
+                {
+                    size_t i = std::hash<std::thread::id>()(std::this_thread::get_id()) % SLOTS;
+                    for (;; i = (i + 1) % SLOTS)
+                    {
+                        uint64_t expected = 0;
+                        if (_domain._slots[i].epoch.compare_exchange_strong(expected, _domain._epoch.load()))
+                            break;
+                    }
+                    _slot = i;
+                    // announce again until the announcement is current
+                    for (;;)
+                    {
+                        uint64_t epoch = _domain._epoch.load();
+                        _domain._slots[_slot].epoch.store(epoch);
+                        if (_domain._epoch.load() == epoch)
+                            break;
+                    }
+                }
+
+                ~Guard(void)
+                {
+                    _domain._slots[_slot].epoch.store(0);
+                }
+
+                Guard(const Guard &) = delete;
+                Guard &operator=(const Guard &) = delete;
+        };
+
+        /**
+         * @param grace Epochs that must pass before a retired node is deleted
+         */
+        EpochDomain(uint64_t grace = 2) :
+            _epoch(1), _retired(nullptr), _retireCount(0), _reclaimed(0), _pending(0), _grace(grace)
+        {
+            for (size_t i = 0; i < SLOTS; ++i)
+                _slots[i].epoch.store(0);
+        }
+
+        /**
+         * Deletes every retired node; no guard may still be held
+         */
+        ~EpochDomain(void)
+        {
+            Retired *entry = _retired.load();
+            while (entry != nullptr)
+            {
+                Retired *next = entry->next;
+                delete entry->node;
+                delete entry;
+                entry = next;
+            }
+        }
+
+        EpochDomain(const EpochDomain &) = delete;
+        EpochDomain &operator=(const EpochDomain &) = delete;
+
+        /**
+         * Hand over a node that is no longer reachable from the container.
+         * The caller must hold a guard.
+         */
+        void Retire(T *node)
+        {
+            Retired *entry = new Retired;
+            entry->node = node;
+            entry->epoch = _epoch.load();
+            push(entry);
+            _pending++;
+            if (++_retireCount % RECLAIM_INTERVAL == 0)
+                Reclaim();
+        }
+
+        /**
+         * Try to advance the epoch, then delete every retired node
+         * whose grace period has passed
+         */
+        void Reclaim(void)
+        {
+            tryAdvance();
+            uint64_t epoch = _epoch.load();
+            Retired *entry = _retired.exchange(nullptr);
+            while (entry != nullptr)
+            {
+                Retired *next = entry->next;
+                if (entry->epoch + _grace <= epoch)
+                {
+                    delete entry->node;
+                    delete entry;
+                    _pending--;
+                    _reclaimed++;
+                }
+                else
+                    push(entry);
+                entry = next;
+            }
+        }
+
+        EpochStats Stats(void) const
+        {
+            EpochStats stats;
+            stats.epoch = _epoch.load();
+            stats.retired = _retireCount.load();
+            stats.reclaimed = _reclaimed.load();
+            stats.pending = _pending.load();
+            return stats;
+        }
+};
+
+#endif /*!_EPOCHDOMAIN_HPP_*/
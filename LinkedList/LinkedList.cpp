@@ -7,10 +7,25 @@
 //============================================================================
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <climits>
+#include <cstdint>
 #include <iostream>
+#include <mutex>
+#include <new>
+#include <random>
+#include <stdexcept>
+#include <thread>
 #include <time.h>
+#include <unordered_map>
 
+#include "BloomFilter.hpp"
+#include "BufferedWriter.hpp"
 #include "CSVparser.hpp"
+#include "EpochDomain.hpp"
+#include "NodePool.hpp"
 
 using namespace std;
 
@@ -32,6 +47,28 @@ struct Bid {
     }
 };
 
+// bid fields a list can be sorted on
+enum SortKey {
+    SORT_BY_ID,
+    SORT_BY_TITLE,
+    SORT_BY_AMOUNT
+};
+
+// how a list reorders itself after a successful search
+enum SearchPolicy {
+    SEARCH_STATIC,          // leave the list in insertion order
+    SEARCH_MOVE_TO_FRONT,   // move the found bid to the head
+    SEARCH_TRANSPOSE        // swap the found bid with the one before it
+};
+
+/**
+ * Scan statistics reported by a LinkedList
+ */
+struct ScanStats {
+    unsigned long long searches; // searches that scanned the list
+    unsigned long long nodes;    // nodes those searches visited
+};
+
 //============================================================================
 // Linked-List class definition
 //============================================================================
@@ -47,32 +84,76 @@ private:
     struct Node {
         Bid bid;
         Node *next;
+        Node *prev;
 
         // default constructor
         Node() {
-            next = nullptr;
+            next = prev = nullptr;
         }
 
         // initialize with a bid
         Node(Bid aBid) {
             bid = aBid;
-            next = nullptr;
+            next = prev = nullptr;
         }
     };
 
+    // index entry: the first node in list order holding a bid id,
+    // and how many nodes hold it
+    struct IndexEntry {
+        Node* first;
+        unsigned int count;
+    };
+
     Node* head;
     Node* tail;
     int size = 0;
 
+    // list nodes come from the list's own slab pool
+    NodePool<Node> nodePool;
+
+    // optional Bloom filter answering most misses without a scan
+    bool filtered = false;
+    BloomFilter bloom;
+
+    // optional hash index from bid id to node for O(1) Search and Remove
+    bool indexed = false;
+    unordered_map<string, IndexEntry> index;
+
+    void bloomAdded(string bidId);
+    void bloomRemoved();
+    void rebuildBloom();
+    // reordering applied by Search, and what scans have cost
+    SearchPolicy policy = SEARCH_STATIC;
+    ScanStats scanStats = ScanStats();
+
+    Node* find(string bidId, unsigned long long* depth = nullptr);
+    void unlink(Node* node);
+    void linkBefore(Node* node, Node* before);
+    void indexAdded(Node* node, bool atFront);
+    void indexRemoved(Node* node);
+    void rebuildIndex();
+    template <typename Less> Node* merge(Node* left, Node* right, Less& less);
+    template <typename Less> void sortBy(Less less);
+
 public:
     LinkedList();
     virtual ~LinkedList();
     void Append(Bid bid);
     void Prepend(Bid bid);
     void PrintList();
+    void PrintList(BufferedWriter& out);
     void Remove(string bidId);
     Bid Search(string bidId);
     int Size();
+    NodePoolStats PoolStats();
+    void SetBloomFilter(bool enabled);
+    BloomFilterStats BloomStats();
+    void SetIndex(bool enabled);
+    bool Indexed();
+    void Sort(SortKey key);
+    void SetSearchPolicy(SearchPolicy searchPolicy);
+    ScanStats SearchStats();
 };
 
 /**
@@ -92,11 +173,12 @@ LinkedList::~LinkedList() {
     Node* current = head;
     Node* temp;
 
-    // loop over each node, detach from list then delete
+    // loop over each node, detach from list then destroy;
+    // the pool frees its slabs once the list is gone
     while (current != nullptr) {
         temp = current; // hang on to current node
         current = current->next; // make current the next node
-        delete temp; // delete the orphan node
+        nodePool.Destroy(temp); // destroy the orphan node
     }
 }
 
@@ -106,7 +188,7 @@ LinkedList::~LinkedList() {
 void LinkedList::Append(Bid bid) {
     // FIXME (2): Implement append logic
     //Create new node
-    Node* node = new Node(bid);
+    Node* node = nodePool.Create(bid);
     //if there is nothing at the head...
     if (nullptr == head) {
         // new node becomes the head and the tail
@@ -116,11 +198,14 @@ void LinkedList::Append(Bid bid) {
     else {
         // make current tail node point to the new node
         tail->next = node;
+        node->prev = tail;
         // and tail becomes the new node
         tail = node;
     }
     //increase size count
     size++;
+    bloomAdded(bid.bidId);
+    indexAdded(node, false);
 }
 
 /**
@@ -129,7 +214,7 @@ void LinkedList::Append(Bid bid) {
 void LinkedList::Prepend(Bid bid) {
     // FIXME (3): Implement prepend logic
     // Create new node
-    Node* node = new Node(bid);
+    Node* node = nodePool.Create(bid);
     // if there is already something at the head...
     if (nullptr == head) {
         // new node points to current head as its next node
@@ -138,23 +223,36 @@ void LinkedList::Prepend(Bid bid) {
     // head now becomes the new node
     else {
         node->next = head;
+        head->prev = node;
         head = node;
     }
     //increase size count
     size++;
+    bloomAdded(bid.bidId);
+    indexAdded(node, true);
 }
 
 /**
  * Simple output of all bids in the list
  */
 void LinkedList::PrintList() {
+    BufferedWriter out;
+    PrintList(out);
+}
+
+/**
+ * Output of all bids in the list to a buffered writer
+ *
+ * @param out The writer for standard output, a pipe or a file
+ */
+void LinkedList::PrintList(BufferedWriter& out) {
     // FIXME (4): Implement print logic
     // start at the head
     Node* cur = head;
     // while loop over each node looking for a match
     while (cur) {
         //output current bidID, title, amount and fund
-        cout << cur->bid.bidId << " : " << cur->bid.title << " | " << cur->bid.amount << " | " << cur->bid.fund << endl;
+        out << cur->bid.bidId << " : " << cur->bid.title << " | " << cur->bid.amount << " | " << cur->bid.fund << '\n';
         //set current equal to next
         cur = cur->next;
     }
@@ -167,38 +265,24 @@ void LinkedList::PrintList() {
 */
 void LinkedList::Remove(string bidId) {
     // FIXME (5): Implement remove logic
-    // start at the head
-    Node* cur = head;
-    // special case if matching node is the head
-    if (cur && cur->bid.bidId == bidId) {
-        // make head point to the next node in the list
-        head = cur->next;
-        delete cur;
-        //decrease size count
-        size--;
-        //return
+    // a bid the filter has never seen cannot be in the list
+    if (filtered && !bloom.MayContain(bidId)) {
         return;
     }
-        
-    // while loop over each node looking for a match
-    while (cur->next) {
-        // if the next node bidID is equal to the current bidID
-        if (bidId == cur->next->bid.bidId) {
-            // hold onto the next node temporarily
-            Node *tmp = cur->next;
-            // make current node point beyond the next node
-            cur->next = cur->next->next;
-            // now free up memory held by temp
-            delete tmp;
-            // decrease size count
-            size--;
-            //return
-            return;
-        }
-        // current node is equal to next node
-        cur = cur->next;
+    // find the first matching node, by index or by scanning
+    Node* cur = find(bidId);
+    // nothing to remove
+    if (cur == nullptr) {
+        return;
     }
-    return;
+    // detach the node from its neighbours, the head and the tail
+    indexRemoved(cur);
+    unlink(cur);
+    // now return the node to the pool
+    nodePool.Destroy(cur);
+    //decrease size count
+    size--;
+    bloomRemoved();
 }
 
 /**
@@ -208,31 +292,107 @@ void LinkedList::Remove(string bidId) {
  */
 Bid LinkedList::Search(string bidId) {
     // FIXME (6): Implement search logic
-    // start at the head of the list
-    Node* cur = head;
-    // special case if matching node is the head    
-    if (cur && cur->bid.bidId == bidId) {
-        // make head point to the next node in the list
-        head = cur->next;
-        delete cur;
-        //decrease size count
-        size--;
-        //return
+    // most misses end here without touching the list
+    if (filtered && !bloom.MayContain(bidId)) {
+        return Bid();
+    }
+    unsigned long long depth = 0;
+    Node* cur = find(bidId, &depth);
+    if (!indexed) {
+        scanStats.searches++;
+        scanStats.nodes += depth;
+    }
+    if (cur == nullptr) {
         return Bid();
     }
-        
+    // an indexed lookup gains nothing from reordering, so the
+    // policy only applies to searches that scanned the list
+    Bid bid = cur->bid;
+    if (!indexed) {
+        if (policy == SEARCH_MOVE_TO_FRONT && cur != head) {
+            unlink(cur);
+            linkBefore(cur, head);
+        }
+        else if (policy == SEARCH_TRANSPOSE && cur != head) {
+            Node* before = cur->prev;
+            unlink(cur);
+            linkBefore(cur, before);
+        }
+    }
+    return bid;
+}
+
+/**
+ * Find the first node in list order holding a bid id
+ *
+ * @param bidId The bid id to search for
+ * @param depth When given, receives the number of nodes scanned
+ * @return the node, or nullptr when no bid matches
+ */
+LinkedList::Node* LinkedList::find(string bidId, unsigned long long* depth) {
+    // one hash lookup when the index is on
+    if (indexed) {
+        auto entry = index.find(bidId);
+        return entry == index.end() ? nullptr : entry->second.first;
+    }
+    // start at the head of the list
+    Node* cur = head;
+    unsigned long long visited = 0;
     // keep searching until end reached with while loop (next != nullptr
     while (cur) {
+        visited++;
         // if the current node matches, return it
         if (bidId == cur->bid.bidId) {
-            return cur->bid;
+            break;
         }
         // else current node is equal to next node
         cur = cur->next;
-        //return bid
-        return Bid();
     }
-    return Bid();
+    if (depth != nullptr) {
+        *depth = visited;
+    }
+    return cur;
+}
+
+/**
+ * Detach a node from the list without destroying it
+ *
+ * @param node The node to detach
+ */
+void LinkedList::unlink(Node* node) {
+    // the previous node, or the head, skips past the node
+    if (node->prev != nullptr) {
+        node->prev->next = node->next;
+    }
+    else {
+        head = node->next;
+    }
+    // the next node, or the tail, points back past the node
+    if (node->next != nullptr) {
+        node->next->prev = node->prev;
+    }
+    else {
+        tail = node->prev;
+    }
+    node->next = node->prev = nullptr;
+}
+
+/**
+ * Link a detached node in ahead of another node
+ *
+ * @param node The detached node
+ * @param before The node that will follow it, never nullptr
+ */
+void LinkedList::linkBefore(Node* node, Node* before) {
+    node->prev = before->prev;
+    node->next = before;
+    if (before->prev != nullptr) {
+        before->prev->next = node;
+    }
+    else {
+        head = node;
+    }
+    before->prev = node;
 }
 
 /**
@@ -242,147 +402,2057 @@ int LinkedList::Size() {
     return size;
 }
 
-//============================================================================
-// Static methods used for testing
-//============================================================================
-
 /**
- * Display the bid information
- *
- * @param bid struct containing the bid info
+ * Returns the allocation statistics of the list's node pool
  */
-void displayBid(Bid bid) {
-    cout << bid.bidId << ": " << bid.title << " | " << bid.amount
-         << " | " << bid.fund << endl;
-    return;
+NodePoolStats LinkedList::PoolStats() {
+    return nodePool.Stats();
 }
 
 /**
- * Prompt user for bid information
- *
- * @return Bid struct containing the bid info
+ * Record an added bid in the Bloom filter, rebuilding it
+ * once the list has outgrown it
  */
-Bid getBid() {
-    Bid bid;
-
-    cout << "Enter Id: ";
-    cin.ignore();
-    getline(cin, bid.bidId);
+void LinkedList::bloomAdded(string bidId) {
+    if (filtered) {
+        bloom.Add(bidId);
+        if (bloom.NeedsRebuild()) {
+            rebuildBloom();
+        }
+    }
+}
 
-    cout << "Enter title: ";
-    getline(cin, bid.title);
+/**
+ * Record a removed bid in the Bloom filter, rebuilding it
+ * once too many of its keys are stale
+ */
+void LinkedList::bloomRemoved() {
+    if (filtered) {
+        bloom.Removed();
+        if (bloom.NeedsRebuild()) {
+            rebuildBloom();
+        }
+    }
+}
 
-    cout << "Enter fund: ";
-    cin >> bid.fund;
+/**
+ * Refill the Bloom filter from the list, sized for twice
+ * the current number of bids
+ */
+void LinkedList::rebuildBloom() {
+    bloom.Clear(size * 2);
+    for (Node* cur = head; cur != nullptr; cur = cur->next) {
+        bloom.Add(cur->bid.bidId);
+    }
+}
 
-    cout << "Enter amount: ";
-    cin.ignore();
-    string strAmount;
-    getline(cin, strAmount);
-    bid.amount = strToDouble(strAmount, '$');
+/**
+ * Turn the Bloom filter in front of Search and Remove on or off
+ *
+ * @param enabled true to build the filter over the current list
+ */
+void LinkedList::SetBloomFilter(bool enabled) {
+    if (enabled && !filtered) {
+        rebuildBloom();
+    }
+    filtered = enabled;
+}
 
-    return bid;
+/**
+ * Returns the size and hit statistics of the Bloom filter
+ */
+BloomFilterStats LinkedList::BloomStats() {
+    return bloom.Stats();
 }
 
 /**
- * Load a CSV file containing bids into a LinkedList
+ * Record a newly linked node in the index
  *
- * @return a LinkedList containing all the bids read
+ * @param node The node just appended or prepended
+ * @param atFront true when the node went in ahead of the others
  */
-void loadBids(string csvPath, LinkedList *list) {
-    cout << "Loading CSV file " << csvPath << endl;
+void LinkedList::indexAdded(Node* node, bool atFront) {
+    if (indexed) {
+        auto inserted = index.insert(make_pair(node->bid.bidId, IndexEntry{ node, 0 }));
+        IndexEntry& entry = inserted.first->second;
+        // a prepended duplicate is now the first match
+        if (atFront) {
+            entry.first = node;
+        }
+        entry.count++;
+    }
+}
 
-    // initialize the CSV Parser
-    csv::Parser file = csv::Parser(csvPath);
+/**
+ * Drop a node that is about to be unlinked from the index
+ *
+ * @param node The node being removed, still linked
+ */
+void LinkedList::indexRemoved(Node* node) {
+    if (indexed) {
+        auto found = index.find(node->bid.bidId);
+        if (found == index.end()) {
+            return;
+        }
+        IndexEntry& entry = found->second;
+        if (--entry.count == 0) {
+            index.erase(found);
+        }
+        // only a duplicated id needs a scan for its next match
+        else if (entry.first == node) {
+            Node* cur = node->next;
+            while (cur != nullptr && cur->bid.bidId != node->bid.bidId) {
+                cur = cur->next;
+            }
+            entry.first = cur;
+        }
+    }
+}
 
-    try {
-        // loop to read rows of a CSV file
-        for (int i = 0; i < file.rowCount(); i++) {
+/**
+ * Refill the index from the list in insertion order
+ */
+void LinkedList::rebuildIndex() {
+    index.clear();
+    index.reserve(size);
+    for (Node* cur = head; cur != nullptr; cur = cur->next) {
+        auto inserted = index.insert(make_pair(cur->bid.bidId, IndexEntry{ cur, 0 }));
+        inserted.first->second.count++;
+    }
+}
 
-            // initialize a bid using data from current row (i)
-            Bid bid;
-            bid.bidId = file[i][1];
-            bid.title = file[i][0];
-            bid.fund = file[i][8];
-            bid.amount = strToDouble(file[i][4], '$');
+/**
+ * Turn the hash index behind Search and Remove on or off
+ *
+ * @param enabled true to index the current list
+ */
+void LinkedList::SetIndex(bool enabled) {
+    if (enabled && !indexed) {
+        indexed = true;
+        rebuildIndex();
+    }
+    else if (!enabled && indexed) {
+        indexed = false;
+        index.clear();
+    }
+}
 
-            //cout << bid.bidId << ": " << bid.title << " | " << bid.fund << " | " << bid.amount << endl;
+/**
+ * Returns true while the hash index is on
+ */
+bool LinkedList::Indexed() {
+    return indexed;
+}
 
-            // add this bid to the end
-            list->Append(bid);
+/**
+ * Merge two sorted runs linked through next, taking from the
+ * left run on ties so the sort stays stable
+ *
+ * @param left The run that came first in the list
+ * @param right The run that came after it
+ * @param less Returns true when the first bid belongs before the second
+ * @return the first node of the merged run
+ */
+template <typename Less>
+LinkedList::Node* LinkedList::merge(Node* left, Node* right, Less& less) {
+    Node first;
+    Node* last = &first;
+    while (left != nullptr && right != nullptr) {
+        if (less(right->bid, left->bid)) {
+            last->next = right;
+            right = right->next;
         }
-    } catch (csv::Error &e) {
-        std::cerr << e.what() << std::endl;
+        else {
+            last->next = left;
+            left = left->next;
+        }
+        last = last->next;
     }
+    last->next = (left != nullptr) ? left : right;
+    return first.next;
 }
 
 /**
- * Simple C function to convert a string to a double
- * after stripping out unwanted char
+ * Choose how Search reorders the list after a hit. The list is
+ * left alone while the index is on, since a search is then one
+ * lookup either way.
  *
- * credit: http://stackoverflow.com/a/24875936
- *
- * @param ch The character to strip out
+ * @param searchPolicy The reordering to apply after each hit
  */
-double strToDouble(string str, char ch) {
-    str.erase(remove(str.begin(), str.end(), ch), str.end());
-    return atof(str.c_str());
+void LinkedList::SetSearchPolicy(SearchPolicy searchPolicy) {
+    policy = searchPolicy;
 }
 
 /**
- * The one and only main() method
+ * Returns how many searches scanned the list and how many
+ * nodes they visited
+ */
+ScanStats LinkedList::SearchStats() {
+    return scanStats;
+}
+
+/**
+ * Stable bottom-up merge sort that relinks the nodes in place.
+ * Nodes are taken off the list one at a time and carried up a
+ * row of bins, where bin i holds a sorted run of 2^i nodes, so
+ * each merge works on nodes that were touched recently. The
+ * prev pointers and the tail are restored in one pass at the end.
  *
- * @param arg[1] path to CSV file to load from (optional)
- * @param arg[2] the bid Id to use when searching the list (optional)
+ * @param less Returns true when the first bid belongs before the second
  */
-int main(int argc, char* argv[]) {
+template <typename Less>
+void LinkedList::sortBy(Less less) {
+    // enough bins for any int size
+    Node* bins[32] = { nullptr };
+    int used = 0;
 
-    // process command line arguments
-    string csvPath, bidKey;
-    switch (argc) {
-    case 2:
-        csvPath = argv[1];
-        bidKey = "98109";
+    Node* cur = head;
+    while (cur != nullptr) {
+        Node* carry = cur;
+        cur = cur->next;
+        carry->next = nullptr;
+
+        // bins hold earlier nodes, so they go on the left
+        int i = 0;
+        for (; i < used && bins[i] != nullptr; ++i) {
+            carry = merge(bins[i], carry, less);
+            bins[i] = nullptr;
+        }
+        bins[i] = carry;
+        if (i == used) {
+            used++;
+        }
+    }
+
+    // higher bins hold the earliest nodes
+    Node* sorted = nullptr;
+    for (int i = 0; i < used; ++i) {
+        if (bins[i] != nullptr) {
+            sorted = merge(bins[i], sorted, less);
+        }
+    }
+    head = sorted;
+
+    // restore the back links and the tail
+    Node* prev = nullptr;
+    for (cur = head; cur != nullptr; cur = cur->next) {
+        cur->prev = prev;
+        prev = cur;
+    }
+    tail = prev;
+}
+
+/**
+ * Sort the list in place, keeping bids with equal keys in
+ * their current order
+ *
+ * @param key The bid field to sort on
+ */
+void LinkedList::Sort(SortKey key) {
+    switch (key) {
+    case SORT_BY_ID:
+        sortBy([](const Bid& a, const Bid& b) { return a.bidId < b.bidId; });
         break;
-    case 3:
-        csvPath = argv[1];
-        bidKey = argv[2];
+    case SORT_BY_TITLE:
+        sortBy([](const Bid& a, const Bid& b) { return a.title < b.title; });
         break;
-    default:
-        csvPath = "eBid_Monthly_Sales_Dec_2016.csv";
-        bidKey = "98109";
+    case SORT_BY_AMOUNT:
+        sortBy([](const Bid& a, const Bid& b) { return a.amount < b.amount; });
+        break;
+    }
+    // the first node holding a duplicated id may have changed
+    if (indexed) {
+        rebuildIndex();
     }
+}
 
-    clock_t ticks;
+//============================================================================
+// Unrolled Linked-List class definition
+//============================================================================
 
-    LinkedList bidList;
+/**
+ * Define a class containing data members and methods to
+ * implement an unrolled linked-list. Each node holds up to
+ * NODE_CAPACITY bid ids, packed next to each other, and the
+ * index of each bid's remaining fields in a shared payload
+ * vector. A search reads only the ids, five cache lines per
+ * node, and touches a payload once an id matches.
+ */
+class UnrolledLinkedList {
 
-    Bid bid;
+private:
+    static const int NODE_CAPACITY = 8;
 
-    int choice = 0;
-    while (choice != 9) {
-        cout << "Menu:" << endl;
-        cout << "  1. Enter a Bid" << endl;
-        cout << "  2. Load Bids" << endl;
-        cout << "  3. Display All Bids" << endl;
-        cout << "  4. Find Bid" << endl;
-        cout << "  5. Remove Bid" << endl;
-        cout << "  9. Exit" << endl;
-        cout << "Enter choice: ";
-        cin >> choice;
+    // Internal structure for list entries: a fill count, the ids
+    // and the payload index of each bid
+    struct Node {
+        int count;
+        Node *next;
+        string bidIds[NODE_CAPACITY];
+        uint32_t payloads[NODE_CAPACITY];
 
-        switch (choice) {
-        case 1:
-            bid = getBid();
-            bidList.Append(bid);
-            displayBid(bid);
+        // default constructor
+        Node() {
+            count = 0;
+            next = nullptr;
+        }
+    };
 
-            break;
+    // the fields of a bid other than its id, which the node holds
+    struct Payload {
+        string title;
+        string fund;
+        double amount = 0.0;
+    };
 
-        case 2:
+    Node* head;
+    Node* tail;
+    int size = 0;
+
+    // nodes come from the list's own slab pool
+    NodePool<Node> nodePool;
+
+    // payloads live in one vector; removed slots are reused
+    vector<Payload> payloads;
+    vector<uint32_t> freePayloads;
+
+    void store(Node* node, int index, Bid& bid);
+    Bid load(Node* node, int index);
+    void removeAt(Node* prev, Node* node, int index);
+
+public:
+    UnrolledLinkedList();
+    virtual ~UnrolledLinkedList();
+    void Append(Bid bid);
+    void Prepend(Bid bid);
+    void PrintList();
+    void PrintList(BufferedWriter& out);
+    void Remove(string bidId);
+    Bid Search(string bidId);
+    int Size();
+};
+
+/**
+ * Default constructor
+ */
+UnrolledLinkedList::UnrolledLinkedList() {
+    head = tail = nullptr;
+}
+
+/**
+ * Destructor
+ */
+UnrolledLinkedList::~UnrolledLinkedList() {
+    Node* current = head;
+    while (current != nullptr) {
+        Node* temp = current;
+        current = current->next;
+        nodePool.Destroy(temp);
+    }
+}
+
+/**
+ * Put a bid's id into a node and its other fields into a free
+ * payload slot, or a new one at the end of the vector
+ *
+ * @param node The node to hold the bid
+ * @param index The position within node
+ * @param bid The bid, whose fields are moved from
+ */
+void UnrolledLinkedList::store(Node* node, int index, Bid& bid) {
+    uint32_t slot;
+    if (!freePayloads.empty()) {
+        slot = freePayloads.back();
+        freePayloads.pop_back();
+    }
+    else {
+        if (payloads.size() >= UINT32_MAX) {
+            throw length_error("UnrolledLinkedList is full");
+        }
+        slot = (uint32_t)payloads.size();
+        payloads.push_back(Payload());
+    }
+    Payload& payload = payloads[slot];
+    payload.title = move(bid.title);
+    payload.fund = move(bid.fund);
+    payload.amount = bid.amount;
+    node->bidIds[index] = move(bid.bidId);
+    node->payloads[index] = slot;
+}
+
+/**
+ * Copy a bid out of a node and its payload
+ *
+ * @param node The node holding the bid
+ * @param index The position within node
+ * @return a copy of the bid
+ */
+Bid UnrolledLinkedList::load(Node* node, int index) {
+    const Payload& payload = payloads[node->payloads[index]];
+    Bid bid;
+    bid.bidId = node->bidIds[index];
+    bid.title = payload.title;
+    bid.fund = payload.fund;
+    bid.amount = payload.amount;
+    return bid;
+}
+
+/**
+ * Append a new bid to the end of the list
+ */
+void UnrolledLinkedList::Append(Bid bid) {
+    // start a new tail node once the current one is full
+    if (tail == nullptr || tail->count == NODE_CAPACITY) {
+        Node* node = nodePool.Create();
+        if (tail == nullptr) {
+            head = tail = node;
+        }
+        else {
+            tail->next = node;
+            tail = node;
+        }
+    }
+    store(tail, tail->count, bid);
+    tail->count++;
+    size++;
+}
+
+/**
+ * Prepend a new bid to the start of the list
+ */
+void UnrolledLinkedList::Prepend(Bid bid) {
+    // start a new head node once the current one is full
+    if (head == nullptr || head->count == NODE_CAPACITY) {
+        Node* node = nodePool.Create();
+        node->next = head;
+        head = node;
+        if (tail == nullptr) {
+            tail = node;
+        }
+    }
+    // shift the head node's ids up one place to make room
+    for (int i = head->count; i > 0; --i) {
+        head->bidIds[i] = move(head->bidIds[i - 1]);
+        head->payloads[i] = head->payloads[i - 1];
+    }
+    store(head, 0, bid);
+    head->count++;
+    size++;
+}
+
+/**
+ * Simple output of all bids in the list
+ */
+void UnrolledLinkedList::PrintList() {
+    BufferedWriter out;
+    PrintList(out);
+}
+
+/**
+ * Output of all bids in the list to a buffered writer
+ *
+ * @param out The writer for standard output, a pipe or a file
+ */
+void UnrolledLinkedList::PrintList(BufferedWriter& out) {
+    for (Node* cur = head; cur != nullptr; cur = cur->next) {
+        for (int i = 0; i < cur->count; ++i) {
+            const Payload& payload = payloads[cur->payloads[i]];
+            out << cur->bidIds[i] << " : " << payload.title << " | "
+                << payload.amount << " | " << payload.fund << '\n';
+        }
+    }
+}
+
+/**
+ * Remove one bid from a node, then merge with or borrow from the
+ * next node so every node but the tail stays at least half full
+ *
+ * @param prev The node before node, nullptr for the head
+ * @param node The node holding the bid
+ * @param index The position of the bid within node
+ */
+void UnrolledLinkedList::removeAt(Node* prev, Node* node, int index) {
+    // free the payload, keeping its slot for the next bid stored
+    Payload& payload = payloads[node->payloads[index]];
+    payload = Payload();
+    freePayloads.push_back(node->payloads[index]);
+
+    // close the gap left by the removed bid
+    for (int i = index; i < node->count - 1; ++i) {
+        node->bidIds[i] = move(node->bidIds[i + 1]);
+        node->payloads[i] = node->payloads[i + 1];
+    }
+    node->count--;
+    node->bidIds[node->count] = string();
+    size--;
+
+    Node* next = node->next;
+    if (node->count < NODE_CAPACITY / 2 && next != nullptr) {
+        // the next node fits entirely, so merge it in
+        if (node->count + next->count <= NODE_CAPACITY) {
+            for (int i = 0; i < next->count; ++i) {
+                node->bidIds[node->count] = move(next->bidIds[i]);
+                node->payloads[node->count] = next->payloads[i];
+                node->count++;
+            }
+            node->next = next->next;
+            if (tail == next) {
+                tail = node;
+            }
+            nodePool.Destroy(next);
+        }
+        // else borrow the first bid of the next node
+        else {
+            node->bidIds[node->count] = move(next->bidIds[0]);
+            node->payloads[node->count] = next->payloads[0];
+            node->count++;
+            for (int i = 0; i < next->count - 1; ++i) {
+                next->bidIds[i] = move(next->bidIds[i + 1]);
+                next->payloads[i] = next->payloads[i + 1];
+            }
+            next->count--;
+            next->bidIds[next->count] = string();
+        }
+    }
+
+    // only a node without a successor can end up empty
+    if (node->count == 0) {
+        if (prev == nullptr) {
+            head = node->next;
+        }
+        else {
+            prev->next = node->next;
+        }
+        if (tail == node) {
+            tail = prev;
+        }
+        nodePool.Destroy(node);
+    }
+}
+
+/**
+ * Remove a specified bid
+ *
+ * @param bidId The bid id to remove from the list
+ */
+void UnrolledLinkedList::Remove(string bidId) {
+    Node* prev = nullptr;
+    for (Node* cur = head; cur != nullptr; cur = cur->next) {
+        for (int i = 0; i < cur->count; ++i) {
+            if (cur->bidIds[i] == bidId) {
+                removeAt(prev, cur, i);
+                return;
+            }
+        }
+        prev = cur;
+    }
+}
+
+/**
+ * Search for the specified bidId
+ *
+ * @param bidId The bid id to search for
+ */
+Bid UnrolledLinkedList::Search(string bidId) {
+    for (Node* cur = head; cur != nullptr; cur = cur->next) {
+        for (int i = 0; i < cur->count; ++i) {
+            if (cur->bidIds[i] == bidId) {
+                return load(cur, i);
+            }
+        }
+    }
+    return Bid();
+}
+
+/**
+ * Returns the current size (number of elements) in the list
+ */
+int UnrolledLinkedList::Size() {
+    return size;
+}
+
+//============================================================================
+// Compact Linked-List class definition
+//============================================================================
+
+/**
+ * Define a class containing data members and methods to
+ * implement a linked-list whose bids live in one vector and
+ * are linked by 32-bit indices instead of pointers. Removed
+ * entries go on a free list for the next insert to reuse.
+ * Until the list is reordered, walking it reads the vector
+ * front to back; Compact puts it back in that state after
+ * heavy churn. The list holds at most 2^32 - 2 bids.
+ */
+class CompactLinkedList {
+
+private:
+    // index meaning "no entry", for the ends of the list
+    static const uint32_t NONE = UINT32_MAX;
+
+    // Internal structure for list entries; a free entry's next
+    // links it into the free list
+    struct Entry {
+        Bid bid;
+        uint32_t next;
+    };
+
+    vector<Entry> entries;
+    uint32_t head;
+    uint32_t tail;
+    uint32_t freeList;
+    int size = 0;
+
+    uint32_t allocate(Bid& bid);
+
+public:
+    CompactLinkedList();
+    void Append(Bid bid);
+    void Prepend(Bid bid);
+    void PrintList();
+    void PrintList(BufferedWriter& out);
+    void Remove(string bidId);
+    Bid Search(string bidId);
+    int Size();
+    void Compact();
+    size_t Capacity();
+};
+
+/**
+ * Default constructor
+ */
+CompactLinkedList::CompactLinkedList() {
+    head = tail = freeList = NONE;
+}
+
+/**
+ * Store a bid in a free entry, or at the end of the vector
+ *
+ * @return the index of the entry, not yet linked into the list
+ */
+uint32_t CompactLinkedList::allocate(Bid& bid) {
+    uint32_t index;
+    if (freeList != NONE) {
+        index = freeList;
+        freeList = entries[index].next;
+    }
+    else {
+        if (entries.size() >= NONE) {
+            throw length_error("CompactLinkedList is full");
+        }
+        index = (uint32_t)entries.size();
+        entries.push_back(Entry());
+    }
+    entries[index].bid = move(bid);
+    entries[index].next = NONE;
+    return index;
+}
+
+/**
+ * Append a new bid to the end of the list
+ */
+void CompactLinkedList::Append(Bid bid) {
+    uint32_t index = allocate(bid);
+    if (head == NONE) {
+        head = tail = index;
+    }
+    else {
+        entries[tail].next = index;
+        tail = index;
+    }
+    size++;
+}
+
+/**
+ * Prepend a new bid to the start of the list
+ */
+void CompactLinkedList::Prepend(Bid bid) {
+    uint32_t index = allocate(bid);
+    entries[index].next = head;
+    head = index;
+    if (tail == NONE) {
+        tail = index;
+    }
+    size++;
+}
+
+/**
+ * Simple output of all bids in the list
+ */
+void CompactLinkedList::PrintList() {
+    BufferedWriter out;
+    PrintList(out);
+}
+
+/**
+ * Output of all bids in the list to a buffered writer
+ *
+ * @param out The writer for standard output, a pipe or a file
+ */
+void CompactLinkedList::PrintList(BufferedWriter& out) {
+    for (uint32_t cur = head; cur != NONE; cur = entries[cur].next) {
+        const Bid& bid = entries[cur].bid;
+        out << bid.bidId << " : " << bid.title << " | " << bid.amount << " | " << bid.fund << '\n';
+    }
+}
+
+/**
+ * Remove a specified bid
+ *
+ * @param bidId The bid id to remove from the list
+ */
+void CompactLinkedList::Remove(string bidId) {
+    uint32_t prev = NONE;
+    for (uint32_t cur = head; cur != NONE; prev = cur, cur = entries[cur].next) {
+        if (entries[cur].bid.bidId == bidId) {
+            // unlink the entry from its neighbour, or the head
+            if (prev == NONE) {
+                head = entries[cur].next;
+            }
+            else {
+                entries[prev].next = entries[cur].next;
+            }
+            if (tail == cur) {
+                tail = prev;
+            }
+            // release the strings and put the entry on the free list
+            entries[cur].bid = Bid();
+            entries[cur].next = freeList;
+            freeList = cur;
+            size--;
+            return;
+        }
+    }
+}
+
+/**
+ * Search for the specified bidId
+ *
+ * @param bidId The bid id to search for
+ */
+Bid CompactLinkedList::Search(string bidId) {
+    for (uint32_t cur = head; cur != NONE; cur = entries[cur].next) {
+        if (entries[cur].bid.bidId == bidId) {
+            return entries[cur].bid;
+        }
+    }
+    return Bid();
+}
+
+/**
+ * Returns the current size (number of elements) in the list
+ */
+int CompactLinkedList::Size() {
+    return size;
+}
+
+/**
+ * Move the bids into a new vector in list order and drop the
+ * free entries, so entry i links to entry i + 1 again. O(n);
+ * the bids are moved, not copied.
+ */
+void CompactLinkedList::Compact() {
+    vector<Entry> packed;
+    packed.reserve(size);
+    for (uint32_t cur = head; cur != NONE; cur = entries[cur].next) {
+        Entry entry;
+        entry.bid = move(entries[cur].bid);
+        entry.next = (uint32_t)packed.size() + 1;
+        packed.push_back(move(entry));
+    }
+    if (packed.empty()) {
+        head = tail = NONE;
+    }
+    else {
+        packed.back().next = NONE;
+        head = 0;
+        tail = (uint32_t)packed.size() - 1;
+    }
+    entries.swap(packed);
+    freeList = NONE;
+}
+
+/**
+ * Returns the number of entries the vector holds, free or not
+ */
+size_t CompactLinkedList::Capacity() {
+    return entries.size();
+}
+
+//============================================================================
+// Skip List class definition
+//============================================================================
+
+/**
+ * Define a class containing data members and methods to
+ * implement a skip list ordered by bid id. Every bid sits on
+ * the bottom level, which reads like a sorted linked-list, and
+ * each level above it skips about three quarters of the nodes
+ * of the level below, so searches take O(log n) steps.
+ */
+class SkipList {
+
+private:
+    static const int MAX_LEVEL = 16;
+
+    // Internal structure for list entries. The forward pointers
+    // are allocated in the same block, right after the bid, so
+    // a node of any level is a single allocation.
+    struct Node {
+        Bid bid;
+        int level;
+        Node* forward[1];
+    };
+
+    Node* head;
+    int level;
+    int size = 0;
+    mt19937 random;
+
+    Node* createNode(int nodeLevel);
+    void destroyNode(Node* node);
+    int randomLevel();
+    Node* lowerBound(string bidId);
+
+public:
+    SkipList();
+    virtual ~SkipList();
+    SkipList(const SkipList&) = delete;
+    SkipList& operator=(const SkipList&) = delete;
+    void Insert(Bid bid);
+    void PrintList();
+    void PrintList(BufferedWriter& out);
+    void Remove(string bidId);
+    Bid Search(string bidId);
+    vector<Bid> RangeScan(string lo, string hi);
+    int Size();
+};
+
+/**
+ * Default constructor
+ */
+SkipList::SkipList() : random(1) {
+    // the head is a sentinel tall enough for every level
+    head = createNode(MAX_LEVEL);
+    level = 1;
+}
+
+/**
+ * Destructor
+ */
+SkipList::~SkipList() {
+    Node* current = head;
+    while (current != nullptr) {
+        Node* temp = current;
+        current = current->forward[0];
+        destroyNode(temp);
+    }
+}
+
+/**
+ * Allocate a node with room for its forward pointers
+ *
+ * @param nodeLevel Number of levels the node is linked into
+ */
+SkipList::Node* SkipList::createNode(int nodeLevel) {
+    void* block = ::operator new(sizeof(Node) + (nodeLevel - 1) * sizeof(Node*));
+    Node* node = new (block) Node();
+    node->level = nodeLevel;
+    for (int i = 0; i < nodeLevel; ++i) {
+        node->forward[i] = nullptr;
+    }
+    return node;
+}
+
+/**
+ * Destroy a node and release its block
+ */
+void SkipList::destroyNode(Node* node) {
+    node->~Node();
+    ::operator delete(node);
+}
+
+/**
+ * Pick a level for a new node: each extra level with
+ * probability 1/4
+ */
+int SkipList::randomLevel() {
+    int nodeLevel = 1;
+    uint32_t bits = random();
+    while (nodeLevel < MAX_LEVEL && (bits & 3) == 0) {
+        nodeLevel++;
+        bits >>= 2;
+    }
+    return nodeLevel;
+}
+
+/**
+ * Find the first node whose bid id is not less than a key
+ *
+ * @param bidId The key to look for
+ * @return the node, or nullptr when every bid id is smaller
+ */
+SkipList::Node* SkipList::lowerBound(string bidId) {
+    Node* cur = head;
+    // drop a level each time the next node would overshoot
+    for (int i = level - 1; i >= 0; --i) {
+        while (cur->forward[i] != nullptr && cur->forward[i]->bid.bidId < bidId) {
+            cur = cur->forward[i];
+        }
+    }
+    return cur->forward[0];
+}
+
+/**
+ * Insert a bid in bid id order. A bid whose id is already
+ * present goes after the existing ones.
+ */
+void SkipList::Insert(Bid bid) {
+    Node* update[MAX_LEVEL];
+    Node* cur = head;
+    // remember the last node before the insertion point on each level
+    for (int i = level - 1; i >= 0; --i) {
+        while (cur->forward[i] != nullptr && !(bid.bidId < cur->forward[i]->bid.bidId)) {
+            cur = cur->forward[i];
+        }
+        update[i] = cur;
+    }
+
+    int nodeLevel = randomLevel();
+    if (nodeLevel > level) {
+        for (int i = level; i < nodeLevel; ++i) {
+            update[i] = head;
+        }
+        level = nodeLevel;
+    }
+
+    Node* node = createNode(nodeLevel);
+    node->bid = bid;
+    for (int i = 0; i < nodeLevel; ++i) {
+        node->forward[i] = update[i]->forward[i];
+        update[i]->forward[i] = node;
+    }
+    size++;
+}
+
+/**
+ * Simple output of all bids in bid id order
+ */
+void SkipList::PrintList() {
+    BufferedWriter out;
+    PrintList(out);
+}
+
+/**
+ * Output of all bids in bid id order to a buffered writer
+ *
+ * @param out The writer for standard output, a pipe or a file
+ */
+void SkipList::PrintList(BufferedWriter& out) {
+    for (Node* cur = head->forward[0]; cur != nullptr; cur = cur->forward[0]) {
+        out << cur->bid.bidId << " : " << cur->bid.title << " | "
+            << cur->bid.amount << " | " << cur->bid.fund << '\n';
+    }
+}
+
+/**
+ * Remove the first bid with a specified bid id
+ *
+ * @param bidId The bid id to remove from the list
+ */
+void SkipList::Remove(string bidId) {
+    Node* update[MAX_LEVEL];
+    Node* cur = head;
+    for (int i = level - 1; i >= 0; --i) {
+        while (cur->forward[i] != nullptr && cur->forward[i]->bid.bidId < bidId) {
+            cur = cur->forward[i];
+        }
+        update[i] = cur;
+    }
+
+    Node* node = cur->forward[0];
+    if (node == nullptr || node->bid.bidId != bidId) {
+        return;
+    }
+    // unlink the node from every level it was linked into
+    for (int i = 0; i < node->level; ++i) {
+        update[i]->forward[i] = node->forward[i];
+    }
+    destroyNode(node);
+    size--;
+
+    // drop levels left empty
+    while (level > 1 && head->forward[level - 1] == nullptr) {
+        level--;
+    }
+}
+
+/**
+ * Search for the specified bidId
+ *
+ * @param bidId The bid id to search for
+ */
+Bid SkipList::Search(string bidId) {
+    Node* node = lowerBound(bidId);
+    if (node != nullptr && node->bid.bidId == bidId) {
+        return node->bid;
+    }
+    return Bid();
+}
+
+/**
+ * Find every bid whose id lies within a range
+ *
+ * @param lo Lowest bid id to include
+ * @param hi Highest bid id to include
+ * @return the matching bids in bid id order
+ */
+vector<Bid> SkipList::RangeScan(string lo, string hi) {
+    vector<Bid> bids;
+    for (Node* cur = lowerBound(lo); cur != nullptr && !(hi < cur->bid.bidId); cur = cur->forward[0]) {
+        bids.push_back(cur->bid);
+    }
+    return bids;
+}
+
+/**
+ * Returns the current size (number of elements) in the list
+ */
+int SkipList::Size() {
+    return size;
+}
+
+//============================================================================
+// Concurrent Linked-List class definition
+//============================================================================
+
+/**
+ * Define a class containing data members and methods to
+ * implement a lock-free linked-list that several threads can
+ * append to, search and remove from at the same time.
+ *
+ * Nodes hang off a sentinel head. Remove first marks a node
+ * removed, then freezes its next pointer by setting the low bit
+ * and swings the predecessor past it, in the manner of Harris's
+ * list; any Remove that walks past a removed node helps finish
+ * the unlink. The last node is never unlinked, since freezing it
+ * would leave nowhere to append, so a removed last node stays in
+ * place, invisible to readers, until something follows it.
+ *
+ * Unlinked nodes go to an epoch domain and are deleted once no
+ * running operation can still hold them. The tail pointer is
+ * only a hint: a lagging appender can swing it onto a node that
+ * has just been unlinked. Whoever puts the tail on a frozen node
+ * moves it on before finishing, and nodes wait one extra epoch
+ * so threads that read the tail in between are covered too.
+ */
+class ConcurrentLinkedList {
+
+private:
+    // low bit of a next pointer, set once the node is being unlinked
+    static const uintptr_t FROZEN = 1;
+
+    //Internal structure for list entries
+    struct Node {
+        Bid bid;
+        atomic<uintptr_t> next;
+        atomic<bool> removed;
+
+        // default constructor
+        Node() : next(0), removed(false) {
+        }
+
+        // initialize with a bid
+        Node(Bid aBid) : bid(aBid), next(0), removed(false) {
+        }
+    };
+
+    Node* head;
+    atomic<Node*> tail;
+    atomic<int> size;
+
+    // unlinked nodes wait here until no operation can see them
+    EpochDomain<Node> epochs;
+
+    static Node* pointer(uintptr_t link);
+    void settleTail(Node* node);
+    bool unlink(Node* pred, Node* node);
+
+public:
+    ConcurrentLinkedList();
+    virtual ~ConcurrentLinkedList();
+    ConcurrentLinkedList(const ConcurrentLinkedList&) = delete;
+    ConcurrentLinkedList& operator=(const ConcurrentLinkedList&) = delete;
+    void Append(Bid bid);
+    void Prepend(Bid bid);
+    void PrintList();
+    void PrintList(BufferedWriter& out);
+    void Remove(string bidId);
+    Bid Search(string bidId);
+    int Size();
+    EpochStats ReclaimStats();
+};
+
+/**
+ * Default constructor
+ */
+ConcurrentLinkedList::ConcurrentLinkedList() : size(0), epochs(3) {
+    head = new Node();
+    tail.store(head);
+}
+
+/**
+ * Destructor; no other thread may still be using the list
+ */
+ConcurrentLinkedList::~ConcurrentLinkedList() {
+    Node* current = head;
+    while (current != nullptr) {
+        Node* temp = current;
+        current = pointer(current->next.load());
+        delete temp;
+    }
+}
+
+/**
+ * Strip the frozen bit from a next pointer
+ */
+ConcurrentLinkedList::Node* ConcurrentLinkedList::pointer(uintptr_t link) {
+    return reinterpret_cast<Node*>(link & ~FROZEN);
+}
+
+/**
+ * Move the tail hint off a node, and off each following node,
+ * for as long as the hint sits on a frozen node
+ *
+ * @param node The node the caller may have left the tail on
+ */
+void ConcurrentLinkedList::settleTail(Node* node) {
+    for (;;) {
+        uintptr_t link = node->next.load();
+        if ((link & FROZEN) == 0) {
+            return;
+        }
+        Node* succ = pointer(link);
+        if (!tail.compare_exchange_strong(node, succ)) {
+            return;
+        }
+        node = succ;
+    }
+}
+
+/**
+ * Unlink a removed node that has a successor. The caller
+ * must hold a guard.
+ *
+ * @param pred The node seen just before node
+ * @return false when pred no longer points at node, and
+ *         the caller has to walk the list again
+ */
+bool ConcurrentLinkedList::unlink(Node* pred, Node* node) {
+    // freeze node's next pointer so nothing can be linked after it
+    uintptr_t link = node->next.load();
+    while ((link & FROZEN) == 0) {
+        if (node->next.compare_exchange_weak(link, link | FROZEN)) {
+            link |= FROZEN;
+        }
+    }
+    Node* succ = pointer(link);
+    settleTail(node);
+
+    uintptr_t expected = reinterpret_cast<uintptr_t>(node);
+    if (pred->next.compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(succ))) {
+        epochs.Retire(node);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Append a new bid to the end of the list
+ */
+void ConcurrentLinkedList::Append(Bid bid) {
+    Node* node = new Node(bid);
+    EpochDomain<Node>::Guard guard(epochs);
+    for (;;) {
+        Node* last = tail.load();
+        uintptr_t link = last->next.load();
+        // the hint is on the last node, so link the new node after it
+        if (link == 0) {
+            uintptr_t expected = 0;
+            if (last->next.compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(node))) {
+                size++;
+                if (tail.compare_exchange_strong(last, node)) {
+                    settleTail(node);
+                }
+                return;
+            }
+            continue;
+        }
+        // else the hint lags behind, so help it along first
+        Node* succ = pointer(link);
+        if (tail.compare_exchange_strong(last, succ)) {
+            settleTail(succ);
+        }
+    }
+}
+
+/**
+ * Prepend a new bid to the start of the list
+ */
+void ConcurrentLinkedList::Prepend(Bid bid) {
+    Node* node = new Node(bid);
+    EpochDomain<Node>::Guard guard(epochs);
+    // the sentinel is never frozen, so only a racing prepend can fail this
+    uintptr_t first = head->next.load();
+    do {
+        node->next.store(first);
+    } while (!head->next.compare_exchange_weak(first, reinterpret_cast<uintptr_t>(node)));
+    size++;
+}
+
+/**
+ * Simple output of all bids in the list
+ */
+void ConcurrentLinkedList::PrintList() {
+    BufferedWriter out;
+    PrintList(out);
+}
+
+/**
+ * Output of all bids in the list to a buffered writer
+ *
+ * @param out The writer for standard output, a pipe or a file
+ */
+void ConcurrentLinkedList::PrintList(BufferedWriter& out) {
+    EpochDomain<Node>::Guard guard(epochs);
+    for (Node* cur = pointer(head->next.load()); cur != nullptr; cur = pointer(cur->next.load())) {
+        if (!cur->removed.load()) {
+            out << cur->bid.bidId << " : " << cur->bid.title << " | "
+                << cur->bid.amount << " | " << cur->bid.fund << '\n';
+        }
+    }
+}
+
+/**
+ * Remove a specified bid
+ *
+ * @param bidId The bid id to remove from the list
+ */
+void ConcurrentLinkedList::Remove(string bidId) {
+    EpochDomain<Node>::Guard guard(epochs);
+    for (;;) {
+        Node* pred = head;
+        Node* cur = pointer(pred->next.load());
+        bool restart = false;
+
+        while (cur != nullptr) {
+            if (cur->removed.load()) {
+                // help unlink removed nodes on the way, except the last
+                if (pointer(cur->next.load()) != nullptr) {
+                    if (!unlink(pred, cur)) {
+                        restart = true;
+                        break;
+                    }
+                    cur = pointer(pred->next.load());
+                    continue;
+                }
+            }
+            else if (cur->bid.bidId == bidId) {
+                // only one of several racing removes wins the node
+                bool expected = false;
+                if (cur->removed.compare_exchange_strong(expected, true)) {
+                    size--;
+                    // a failed unlink is left for the next Remove to finish
+                    if (pointer(cur->next.load()) != nullptr) {
+                        unlink(pred, cur);
+                    }
+                    return;
+                }
+                continue;
+            }
+            pred = cur;
+            cur = pointer(cur->next.load());
+        }
+
+        if (!restart) {
+            return;
+        }
+    }
+}
+
+/**
+ * Search for the specified bidId
+ *
+ * @param bidId The bid id to search for
+ */
+Bid ConcurrentLinkedList::Search(string bidId) {
+    EpochDomain<Node>::Guard guard(epochs);
+    for (Node* cur = pointer(head->next.load()); cur != nullptr; cur = pointer(cur->next.load())) {
+        if (!cur->removed.load() && cur->bid.bidId == bidId) {
+            return cur->bid;
+        }
+    }
+    return Bid();
+}
+
+/**
+ * Returns the current size (number of elements) in the list
+ */
+int ConcurrentLinkedList::Size() {
+    return size.load();
+}
+
+/**
+ * Returns the reclamation statistics of the list's epoch domain
+ */
+EpochStats ConcurrentLinkedList::ReclaimStats() {
+    return epochs.Stats();
+}
+
+//============================================================================
+// Static methods used for testing
+//============================================================================
+
+/**
+ * Display the bid information
+ *
+ * @param bid struct containing the bid info
+ */
+void displayBid(Bid bid) {
+    cout << bid.bidId << ": " << bid.title << " | " << bid.amount
+         << " | " << bid.fund << endl;
+    return;
+}
+
+/**
+ * Display the allocation statistics of a node pool
+ *
+ * @param stats statistics reported by the pool
+ */
+void displayPoolStats(NodePoolStats stats) {
+    cout << "slabs: " << stats.slabs << " (" << stats.bytes << " bytes)" << endl;
+    cout << "nodes: " << stats.live << " live of " << stats.capacity << " capacity" << endl;
+    cout << "allocations: " << stats.allocations << " (" << stats.reuses
+         << " from free list)" << endl;
+}
+
+/**
+ * Prompt user for bid information
+ *
+ * @return Bid struct containing the bid info
+ */
+Bid getBid() {
+    Bid bid;
+
+    cout << "Enter Id: ";
+    cin.ignore();
+    getline(cin, bid.bidId);
+
+    cout << "Enter title: ";
+    getline(cin, bid.title);
+
+    cout << "Enter fund: ";
+    cin >> bid.fund;
+
+    cout << "Enter amount: ";
+    cin.ignore();
+    string strAmount;
+    getline(cin, strAmount);
+    bid.amount = strToDouble(strAmount, '$');
+
+    return bid;
+}
+
+/**
+ * Load a CSV file containing bids into a LinkedList
+ *
+ * @param ordered When given, also receives every bid in bid id order
+ * @return a LinkedList containing all the bids read
+ */
+void loadBids(string csvPath, LinkedList *list, SkipList *ordered = nullptr) {
+    cout << "Loading CSV file " << csvPath << endl;
+
+    // initialize the CSV Parser
+    csv::Parser file = csv::Parser(csvPath);
+
+    try {
+        // loop to read rows of a CSV file
+        for (int i = 0; i < file.rowCount(); i++) {
+
+            // initialize a bid using data from current row (i)
+            Bid bid;
+            bid.bidId = file[i][1];
+            bid.title = file[i][0];
+            bid.fund = file[i][8];
+            bid.amount = strToDouble(file[i][4], '$');
+
+            //cout << bid.bidId << ": " << bid.title << " | " << bid.fund << " | " << bid.amount << endl;
+
+            // add this bid to the end
+            list->Append(bid);
+            if (ordered != nullptr) {
+                ordered->Insert(bid);
+            }
+        }
+    } catch (csv::Error &e) {
+        std::cerr << e.what() << std::endl;
+    }
+}
+
+/**
+ * Measure the false positive rate of the Bloom filter and what
+ * it saves on full list scans for bids that do not exist. The
+ * index is turned off for the run and restored afterwards.
+ *
+ * @param list The loaded list to search
+ * @param misses Number of missing bid ids to search for
+ */
+void benchmarkBloom(LinkedList* list, unsigned int misses) {
+    clock_t ticks;
+    unsigned int found = 0;
+
+    // no loaded bid id holds a letter, and with the index off
+    // an unfiltered miss scans the whole list
+    vector<string> ids;
+    for (unsigned int i = 0; i < misses; ++i) {
+        ids.push_back("x" + to_string(i));
+    }
+    bool indexed = list->Indexed();
+    list->SetIndex(false);
+
+    list->SetBloomFilter(false);
+    ticks = clock();
+    for (auto const& id : ids) {
+        found += list->Search(id).bidId.empty() ? 0 : 1;
+    }
+    ticks = clock() - ticks;
+    cout << "without filter: " << ticks * 1.0e9 / CLOCKS_PER_SEC / max(misses, 1u)
+         << " nanoseconds per miss" << endl;
+
+    list->SetBloomFilter(true);
+    BloomFilterStats before = list->BloomStats();
+    ticks = clock();
+    for (auto const& id : ids) {
+        found += list->Search(id).bidId.empty() ? 0 : 1;
+    }
+    ticks = clock() - ticks;
+    BloomFilterStats after = list->BloomStats();
+    cout << "with filter: " << ticks * 1.0e9 / CLOCKS_PER_SEC / max(misses, 1u)
+         << " nanoseconds per miss" << endl;
+
+    size_t queries = after.queries - before.queries;
+    size_t positives = after.positives - before.positives;
+    cout << "false positive rate: " << (queries == 0 ? 0.0 : positives * 100.0 / queries)
+         << "% (" << positives << " of " << queries << ")" << endl;
+    cout << "filter: " << after.keys << " keys in " << after.bytes << " bytes" << endl;
+    cout << found << " unexpected hits" << endl;
+    list->SetIndex(indexed);
+}
+
+/**
+ * Create a synthetic bid for benchmarks larger than the CSV files
+ *
+ * @param n Sequence number used as the bid id
+ * @return a bid with the given id
+ */
+Bid makeBid(unsigned int n) {
+    Bid bid;
+    bid.bidId = to_string(n);
+    bid.title = "Synthetic Bid " + bid.bidId;
+    bid.fund = (n % 2 == 0) ? "General Fund" : "Enterprise";
+    bid.amount = (n % 100000) / 100.0;
+    return bid;
+}
+
+/**
+ * Compare appending to and scanning the linked-list against
+ * the unrolled linked-list
+ *
+ * @param count Number of synthetic bids to load into each list
+ * @param searches Number of searches to run against each list
+ */
+void benchmarkUnrolled(unsigned int count, unsigned int searches) {
+    clock_t ticks;
+    LinkedList* list = new LinkedList();
+    UnrolledLinkedList* unrolled = new UnrolledLinkedList();
+
+    ticks = clock();
+    for (unsigned int i = 0; i < count; ++i) {
+        list->Append(makeBid(i));
+    }
+    ticks = clock() - ticks;
+    cout << "linked-list append: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+
+    ticks = clock();
+    for (unsigned int i = 0; i < count; ++i) {
+        unrolled->Append(makeBid(i));
+    }
+    ticks = clock() - ticks;
+    cout << "unrolled append: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+
+    // half the ids are present at random positions, half are missing
+    vector<string> ids;
+    mt19937 random(1);
+    for (unsigned int i = 0; i < searches; ++i) {
+        ids.push_back(i % 2 == 0 ? to_string(random() % max(count, 1u)) : to_string(count + i));
+    }
+    unsigned int found = 0;
+
+    ticks = clock();
+    for (auto const& id : ids) {
+        found += list->Search(id).bidId.empty() ? 0 : 1;
+    }
+    ticks = clock() - ticks;
+    cout << "linked-list search: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds ("
+         << found << " found)" << endl;
+
+    found = 0;
+    ticks = clock();
+    for (auto const& id : ids) {
+        found += unrolled->Search(id).bidId.empty() ? 0 : 1;
+    }
+    ticks = clock() - ticks;
+    cout << "unrolled search: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds ("
+         << found << " found)" << endl;
+
+    delete list;
+    delete unrolled;
+}
+
+/**
+ * Compare searching and removing by bid id with the list
+ * scanned and with the list indexed
+ *
+ * @param count Number of synthetic bids to load into each list
+ * @param lookups Number of searches, then removes, against each list
+ */
+void benchmarkIndexed(unsigned int count, unsigned int lookups) {
+    clock_t ticks;
+    LinkedList* lists[2] = { new LinkedList(), new LinkedList() };
+    const char* names[2] = { "scanned", "indexed" };
+    lists[1]->SetIndex(true);
+
+    // random ids that are all present in both lists
+    vector<string> ids;
+    mt19937 random(1);
+    for (unsigned int i = 0; i < lookups; ++i) {
+        ids.push_back(to_string(random() % max(count, 1u)));
+    }
+
+    for (int l = 0; l < 2; ++l) {
+        ticks = clock();
+        for (unsigned int i = 0; i < count; ++i) {
+            lists[l]->Append(makeBid(i));
+        }
+        ticks = clock() - ticks;
+        cout << names[l] << " append: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+
+        unsigned int found = 0;
+        ticks = clock();
+        for (auto const& id : ids) {
+            found += lists[l]->Search(id).bidId.empty() ? 0 : 1;
+        }
+        ticks = clock() - ticks;
+        cout << names[l] << " search: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds ("
+             << found << " found)" << endl;
+
+        ticks = clock();
+        for (auto const& id : ids) {
+            lists[l]->Remove(id);
+        }
+        ticks = clock() - ticks;
+        cout << names[l] << " remove: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds ("
+             << lists[l]->Size() << " left)" << endl;
+
+        delete lists[l];
+    }
+}
+
+/**
+ * Compare searching the linked-list against the skip list,
+ * then time one range scan over the skip list
+ *
+ * @param count Number of synthetic bids to load into each list
+ * @param searches Number of searches to run against each list
+ */
+void benchmarkSkipList(unsigned int count, unsigned int searches) {
+    clock_t ticks;
+    LinkedList* list = new LinkedList();
+    SkipList* skipList = new SkipList();
+
+    // shuffled so the skip list sees inserts all over its range
+    vector<unsigned int> order;
+    for (unsigned int i = 0; i < count; ++i) {
+        order.push_back(i);
+    }
+    mt19937 random(1);
+    shuffle(order.begin(), order.end(), random);
+
+    ticks = clock();
+    for (unsigned int n : order) {
+        list->Append(makeBid(n));
+    }
+    ticks = clock() - ticks;
+    cout << "linked-list append: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+
+    ticks = clock();
+    for (unsigned int n : order) {
+        skipList->Insert(makeBid(n));
+    }
+    ticks = clock() - ticks;
+    cout << "skip list insert: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+
+    vector<string> ids;
+    for (unsigned int i = 0; i < searches; ++i) {
+        ids.push_back(to_string(random() % max(count, 1u)));
+    }
+    unsigned int found = 0;
+
+    ticks = clock();
+    for (auto const& id : ids) {
+        found += list->Search(id).bidId.empty() ? 0 : 1;
+    }
+    ticks = clock() - ticks;
+    cout << "linked-list search: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds ("
+         << found << " found)" << endl;
+
+    found = 0;
+    ticks = clock();
+    for (auto const& id : ids) {
+        found += skipList->Search(id).bidId.empty() ? 0 : 1;
+    }
+    ticks = clock() - ticks;
+    cout << "skip list search: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds ("
+         << found << " found)" << endl;
+
+    // ids compare as strings, so this takes every id starting with a 1
+    ticks = clock();
+    vector<Bid> range = skipList->RangeScan("1", "2");
+    ticks = clock() - ticks;
+    cout << "skip list range scan: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds ("
+         << range.size() << " bids)" << endl;
+
+    delete list;
+    delete skipList;
+}
+
+/**
+ * Run producer, remover and reader threads against one concurrent
+ * list, then check what is left. Each producer appends its own
+ * range of ids and removes every other one as it goes, while
+ * readers search for ids from all ranges.
+ *
+ * @param threads Number of producer threads, and of reader threads
+ * @param count Number of bids each producer appends
+ */
+void stressConcurrent(unsigned int threads, unsigned int count) {
+    ConcurrentLinkedList* list = new ConcurrentLinkedList();
+    atomic<bool> done(false);
+    atomic<unsigned int> searches(0);
+    vector<thread> producers;
+    vector<thread> readers;
+
+    auto start = chrono::steady_clock::now();
+    for (unsigned int t = 0; t < threads; ++t) {
+        producers.push_back(thread([=]() {
+            for (unsigned int i = 0; i < count; ++i) {
+                list->Append(makeBid(t * count + i));
+                // remove the previous even id, never far behind the tail
+                if (i % 2 == 1) {
+                    list->Remove(to_string(t * count + i - 1));
+                }
+            }
+        }));
+        readers.push_back(thread([=, &done, &searches]() {
+            mt19937 random(t + 1);
+            while (!done.load()) {
+                list->Search(to_string(random() % (threads * count)));
+                searches++;
+            }
+        }));
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    done.store(true);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+    // every odd offset in a range must be present and every even one gone
+    unsigned int expected = threads * (count / 2);
+    unsigned int wrong = 0;
+    unsigned int checked = 0;
+    mt19937 random(1);
+    for (unsigned int i = 0; i < 1000 && threads * count > 0; ++i) {
+        unsigned int n = random() % (threads * count);
+        // producers remove by offset within their own range, and an
+        // odd count leaves each range's last, even, offset in place
+        unsigned int offset = n % count;
+        bool present = offset % 2 == 1 || (count % 2 == 1 && offset == count - 1);
+        if (present != !list->Search(to_string(n)).bidId.empty()) {
+            wrong++;
+        }
+        checked++;
+    }
+    if (count % 2 == 1) {
+        expected += threads;
+    }
+
+    EpochStats stats = list->ReclaimStats();
+    cout << "size: " << list->Size() << " (expected " << expected << ")" << endl;
+    cout << "checked: " << checked << " ids, " << wrong << " wrong" << endl;
+    cout << "searches: " << searches.load() << " during the run" << endl;
+    cout << "reclaimed: " << stats.reclaimed << " of " << stats.retired
+         << " removed nodes (epoch " << stats.epoch << ")" << endl;
+    cout << "time: " << elapsed.count() << " seconds" << endl;
+
+    delete list;
+}
+
+/**
+ * Time a fixed number of appends spread over 1, 2, 4 ... threads,
+ * into the lock-free list and into a linked-list behind a mutex
+ *
+ * @param maxThreads Largest number of producer threads to try
+ * @param count Number of bids appended in each run
+ */
+void benchmarkConcurrent(unsigned int maxThreads, unsigned int count) {
+    // bids are made up front so only the appends are timed
+    vector<Bid> bids;
+    for (unsigned int i = 0; i < count; ++i) {
+        bids.push_back(makeBid(i));
+    }
+
+    for (unsigned int threads = 1; threads <= max(maxThreads, 1u); threads *= 2) {
+        unsigned int share = (count + threads - 1) / threads;
+        vector<thread> producers;
+
+        // clock() adds up every thread's processor time, so time the wall clock
+        ConcurrentLinkedList* lockFree = new ConcurrentLinkedList();
+        auto start = chrono::steady_clock::now();
+        for (unsigned int t = 0; t < threads; ++t) {
+            producers.push_back(thread([&, t]() {
+                for (unsigned int i = t * share; i < min(count, (t + 1) * share); ++i) {
+                    lockFree->Append(bids[i]);
+                }
+            }));
+        }
+        for (auto& producer : producers) {
+            producer.join();
+        }
+        chrono::duration<double> lockFreeTime = chrono::steady_clock::now() - start;
+        producers.clear();
+
+        LinkedList* locked = new LinkedList();
+        mutex lock;
+        start = chrono::steady_clock::now();
+        for (unsigned int t = 0; t < threads; ++t) {
+            producers.push_back(thread([&, t]() {
+                for (unsigned int i = t * share; i < min(count, (t + 1) * share); ++i) {
+                    lock_guard<mutex> hold(lock);
+                    locked->Append(bids[i]);
+                }
+            }));
+        }
+        for (auto& producer : producers) {
+            producer.join();
+        }
+        chrono::duration<double> lockedTime = chrono::steady_clock::now() - start;
+
+        cout << threads << " threads: lock-free " << lockFreeTime.count() << " seconds ("
+             << lockFree->Size() << " bids), mutex " << lockedTime.count() << " seconds ("
+             << locked->Size() << " bids)" << endl;
+
+        delete lockFree;
+        delete locked;
+    }
+}
+
+/**
+ * Compare sorting the list in place against copying its bids
+ * into a vector and calling std::sort
+ *
+ * @param count Number of synthetic bids, appended in random order
+ * @param key The bid field to sort on
+ */
+void benchmarkSort(unsigned int count, SortKey key) {
+    clock_t ticks;
+    vector<unsigned int> order;
+    for (unsigned int i = 0; i < count; ++i) {
+        order.push_back(i);
+    }
+    shuffle(order.begin(), order.end(), mt19937(1));
+
+    LinkedList* list = new LinkedList();
+    vector<Bid> source;
+    for (unsigned int n : order) {
+        list->Append(makeBid(n));
+        source.push_back(makeBid(n));
+    }
+
+    ticks = clock();
+    list->Sort(key);
+    ticks = clock() - ticks;
+    cout << "list merge sort: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+
+    // copy out, as the reports did, then sort the copy
+    ticks = clock();
+    vector<Bid> bids(source);
+    switch (key) {
+    case SORT_BY_ID:
+        sort(bids.begin(), bids.end(), [](const Bid& a, const Bid& b) { return a.bidId < b.bidId; });
+        break;
+    case SORT_BY_TITLE:
+        sort(bids.begin(), bids.end(), [](const Bid& a, const Bid& b) { return a.title < b.title; });
+        break;
+    case SORT_BY_AMOUNT:
+        sort(bids.begin(), bids.end(), [](const Bid& a, const Bid& b) { return a.amount < b.amount; });
+        break;
+    }
+    ticks = clock() - ticks;
+    cout << "vector copy and std::sort: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+
+    delete list;
+}
+
+/**
+ * Measure the average scan depth and search time of each search
+ * policy when a few bids get most of the searches. Bid ids are
+ * ranked in random order and searched with Zipf frequencies,
+ * rank r being searched in proportion to 1 / r^skew.
+ *
+ * @param count Number of synthetic bids in the list
+ * @param searches Number of searches to run against each policy
+ * @param skew Zipf exponent; 0 searches every bid equally often
+ */
+void benchmarkSearchPolicy(unsigned int count, unsigned int searches, double skew) {
+    const SearchPolicy policies[3] = { SEARCH_STATIC, SEARCH_MOVE_TO_FRONT, SEARCH_TRANSPOSE };
+    const char* names[3] = { "static", "move-to-front", "transpose" };
+    mt19937 random(1);
+
+    // append in random order and rank in another random order
+    vector<unsigned int> order;
+    for (unsigned int i = 0; i < count; ++i) {
+        order.push_back(i);
+    }
+    shuffle(order.begin(), order.end(), random);
+    vector<unsigned int> ranked(order);
+    shuffle(ranked.begin(), ranked.end(), random);
+
+    // draw every search up front from the Zipf distribution
+    vector<double> cumulative;
+    double total = 0.0;
+    for (unsigned int r = 1; r <= count; ++r) {
+        total += 1.0 / pow(r, skew);
+        cumulative.push_back(total);
+    }
+    uniform_real_distribution<double> uniform(0.0, total);
+    vector<string> ids;
+    for (unsigned int i = 0; i < searches && count > 0; ++i) {
+        size_t rank = lower_bound(cumulative.begin(), cumulative.end(), uniform(random)) - cumulative.begin();
+        ids.push_back(to_string(ranked[min(rank, cumulative.size() - 1)]));
+    }
+
+    for (int p = 0; p < 3; ++p) {
+        LinkedList* list = new LinkedList();
+        for (unsigned int n : order) {
+            list->Append(makeBid(n));
+        }
+        list->SetSearchPolicy(policies[p]);
+
+        unsigned int found = 0;
+        clock_t ticks = clock();
+        for (auto const& id : ids) {
+            found += list->Search(id).bidId.empty() ? 0 : 1;
+        }
+        ticks = clock() - ticks;
+
+        ScanStats stats = list->SearchStats();
+        cout << names[p] << ": " << (stats.searches == 0 ? 0.0 : stats.nodes * 1.0 / stats.searches)
+             << " nodes per search, " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds ("
+             << found << " found)" << endl;
+        delete list;
+    }
+}
+
+/**
+ * Compare full scans of the linked-list and the compact list,
+ * before churn, after churn and after compacting. Churn removes
+ * a random quarter of the bids and appends as many new ones,
+ * which land in the freed entries all over the vector.
+ *
+ * @param count Number of synthetic bids in each list
+ * @param scans Number of searches for a missing id, each a full scan
+ */
+void benchmarkCompact(unsigned int count, unsigned int scans) {
+    LinkedList* list = new LinkedList();
+    CompactLinkedList* compact = new CompactLinkedList();
+    for (unsigned int i = 0; i < count; ++i) {
+        list->Append(makeBid(i));
+        compact->Append(makeBid(i));
+    }
+
+    // times scans of both lists for an id that is never there
+    auto timeScans = [&](const char* stage) {
+        clock_t ticks = clock();
+        for (unsigned int i = 0; i < scans; ++i) {
+            list->Search("missing");
+        }
+        double listTime = (clock() - ticks) * 1.0 / CLOCKS_PER_SEC;
+        ticks = clock();
+        for (unsigned int i = 0; i < scans; ++i) {
+            compact->Search("missing");
+        }
+        double compactTime = (clock() - ticks) * 1.0 / CLOCKS_PER_SEC;
+        cout << stage << ": linked-list " << listTime << " seconds, compact "
+             << compactTime << " seconds (" << compact->Size() << " bids in "
+             << compact->Capacity() << " entries)" << endl;
+    };
+
+    timeScans("loaded");
+
+    // every remove is a scan, so churn a quarter of the bids
+    vector<unsigned int> removed;
+    mt19937 random(1);
+    for (unsigned int i = 0; i < count; ++i) {
+        if (random() % 4 == 0) {
+            removed.push_back(i);
+        }
+    }
+    shuffle(removed.begin(), removed.end(), random);
+    for (size_t r = 0; r < removed.size(); ++r) {
+        string id = to_string(removed[r]);
+        list->Remove(id);
+        compact->Remove(id);
+        list->Append(makeBid(count + r));
+        compact->Append(makeBid(count + r));
+    }
+    timeScans("churned");
+
+    compact->Compact();
+    timeScans("compacted");
+
+    delete list;
+    delete compact;
+}
+
+/**
+ * Prompt for the field to sort on
+ *
+ * @return the chosen sort key
+ */
+SortKey getSortKey() {
+    int key = 0;
+    cout << "Sort by 1. id, 2. title or 3. amount: ";
+    cin >> key;
+    switch (key) {
+    case 2:
+        return SORT_BY_TITLE;
+    case 3:
+        return SORT_BY_AMOUNT;
+    default:
+        return SORT_BY_ID;
+    }
+}
+
+/**
+ * Simple C function to convert a string to a double
+ * after stripping out unwanted char
+ *
+ * credit: http://stackoverflow.com/a/24875936
+ *
+ * @param ch The character to strip out
+ */
+double strToDouble(string str, char ch) {
+    str.erase(remove(str.begin(), str.end(), ch), str.end());
+    return atof(str.c_str());
+}
+
+/**
+ * The one and only main() method
+ *
+ * @param arg[1] path to CSV file to load from (optional)
+ * @param arg[2] the bid Id to use when searching the list (optional)
+ */
+int main(int argc, char* argv[]) {
+
+    // process command line arguments
+    string csvPath, bidKey;
+    switch (argc) {
+    case 2:
+        csvPath = argv[1];
+        bidKey = "98109";
+        break;
+    case 3:
+        csvPath = argv[1];
+        bidKey = argv[2];
+        break;
+    default:
+        csvPath = "eBid_Monthly_Sales_Dec_2016.csv";
+        bidKey = "98109";
+    }
+
+    clock_t ticks;
+
+    LinkedList bidList;
+    bidList.SetBloomFilter(true);
+    bidList.SetIndex(true);
+
+    // the same bids in bid id order, for range queries
+    SkipList orderedBids;
+    vector<Bid> bids;
+    string low;
+    string high;
+
+    Bid bid;
+    unsigned int count = 0;
+    unsigned int searches = 0;
+    unsigned int threads = 0;
+    SortKey sortKey = SORT_BY_ID;
+    double skew = 1.0;
+    int policy = 1;
+
+    int choice = 0;
+    while (choice != 9) {
+        cout << "Menu:" << endl;
+        cout << "  1. Enter a Bid" << endl;
+        cout << "  2. Load Bids" << endl;
+        cout << "  3. Display All Bids" << endl;
+        cout << "  4. Find Bid" << endl;
+        cout << "  5. Remove Bid" << endl;
+        cout << "  6. Show Node Pool Statistics" << endl;
+        cout << "  7. Benchmark Bloom Filter" << endl;
+        cout << "  8. Benchmark Unrolled List" << endl;
+        cout << "  10. Toggle Bid Id Index" << endl;
+        cout << "  11. Benchmark Indexed List" << endl;
+        cout << "  12. Find Bids by Id Range" << endl;
+        cout << "  13. Benchmark Skip List" << endl;
+        cout << "  14. Stress Test Concurrent List" << endl;
+        cout << "  15. Benchmark Concurrent Appends" << endl;
+        cout << "  16. Sort Bids" << endl;
+        cout << "  17. Benchmark List Sort" << endl;
+        cout << "  18. Set Search Policy" << endl;
+        cout << "  19. Benchmark Search Policies" << endl;
+        cout << "  20. Benchmark Compact List" << endl;
+        cout << "  9. Exit" << endl;
+        cout << "Enter choice: ";
+        cin >> choice;
+
+        switch (choice) {
+        case 1:
+            bid = getBid();
+            bidList.Append(bid);
+            orderedBids.Insert(bid);
+            displayBid(bid);
+
+            break;
+
+        case 2:
             ticks = clock();
 
-            loadBids(csvPath, &bidList);
+            loadBids(csvPath, &bidList, &orderedBids);
 
             cout << bidList.Size() << " bids read" << endl;
 
@@ -418,6 +2488,142 @@ int main(int argc, char* argv[]) {
 
         case 5:
             bidList.Remove(bidKey);
+            orderedBids.Remove(bidKey);
+
+            break;
+
+        case 6:
+            displayPoolStats(bidList.PoolStats());
+
+            break;
+
+        case 7:
+            cout << "Number of missing bids to search for: ";
+            cin >> count;
+            benchmarkBloom(&bidList, count);
+
+            break;
+
+        case 8:
+            cout << "Number of bids: ";
+            cin >> count;
+            cout << "Number of searches: ";
+            cin >> searches;
+            benchmarkUnrolled(count, searches);
+
+            break;
+
+        case 10:
+            bidList.SetIndex(!bidList.Indexed());
+            cout << "Bid id index " << (bidList.Indexed() ? "on" : "off") << endl;
+
+            break;
+
+        case 11:
+            cout << "Number of bids: ";
+            cin >> count;
+            cout << "Number of searches and removes: ";
+            cin >> searches;
+            benchmarkIndexed(count, searches);
+
+            break;
+
+        case 12:
+            cout << "Enter lowest bid id: ";
+            cin >> low;
+            cout << "Enter highest bid id: ";
+            cin >> high;
+
+            ticks = clock();
+            bids = orderedBids.RangeScan(low, high);
+            ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+
+            for (auto const& found : bids) {
+                displayBid(found);
+            }
+            cout << bids.size() << " bids found" << endl;
+            cout << "time: " << ticks << " clock ticks" << endl;
+            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+            bids.clear();
+            break;
+
+        case 13:
+            cout << "Number of bids: ";
+            cin >> count;
+            cout << "Number of searches: ";
+            cin >> searches;
+            benchmarkSkipList(count, searches);
+
+            break;
+
+        case 14:
+            cout << "Number of threads: ";
+            cin >> threads;
+            cout << "Number of bids per thread: ";
+            cin >> count;
+            stressConcurrent(threads, count);
+
+            break;
+
+        case 15:
+            cout << "Most threads: ";
+            cin >> threads;
+            cout << "Number of bids: ";
+            cin >> count;
+            benchmarkConcurrent(threads, count);
+
+            break;
+
+        case 16:
+            sortKey = getSortKey();
+            ticks = clock();
+
+            bidList.Sort(sortKey);
+
+            ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+            cout << "time: " << ticks << " clock ticks" << endl;
+            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+
+            break;
+
+        case 17:
+            sortKey = getSortKey();
+            cout << "Number of bids: ";
+            cin >> count;
+            benchmarkSort(count, sortKey);
+
+            break;
+
+        case 18:
+            cout << "Search policy 1. static, 2. move-to-front or 3. transpose: ";
+            cin >> policy;
+            bidList.SetSearchPolicy(policy == 2 ? SEARCH_MOVE_TO_FRONT
+                                  : policy == 3 ? SEARCH_TRANSPOSE : SEARCH_STATIC);
+            // an indexed search never scans, so reordering needs the index off
+            if ((policy == 2 || policy == 3) && bidList.Indexed()) {
+                bidList.SetIndex(false);
+                cout << "Bid id index off so searches reorder the list" << endl;
+            }
+
+            break;
+
+        case 19:
+            cout << "Number of bids: ";
+            cin >> count;
+            cout << "Number of searches: ";
+            cin >> searches;
+            cout << "Zipf skew: ";
+            cin >> skew;
+            benchmarkSearchPolicy(count, searches, skew);
+
+            break;
+
+        case 20:
+            cout << "Number of bids: ";
+            cin >> count;
+            cout << "Number of full scans: ";
+            cin >> searches;
+            benchmarkCompact(count, searches);
 
             break;
         }
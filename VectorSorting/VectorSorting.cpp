@@ -10,6 +10,7 @@
 #include <iostream>
 #include <time.h>
 
+#include "BufferedWriter.hpp"
 #include "CSVparser.hpp"
 
 using namespace std;
@@ -47,6 +48,20 @@ void displayBid(Bid bid) {
     return;
 }
 
+/**
+ * Display every bid through one buffered writer instead of
+ * flushing std::out once per bid
+ *
+ * @param bids the bids to display
+ */
+void displayBids(vector<Bid>& bids) {
+    BufferedWriter out;
+    for (unsigned int i = 0; i < bids.size(); ++i) {
+        out << bids[i].bidId << ": " << bids[i].title << " | " << bids[i].amount << " | "
+                << bids[i].fund << '\n';
+    }
+}
+
 /**
  * Prompt user for bid information using console (std::in)
  *
@@ -309,10 +324,8 @@ int main(int argc, char* argv[]) {
             break;
 
         case 2:
-            // Loop and display the bids read
-            for (int i = 0; i < bids.size(); ++i) {
-                displayBid(bids[i]);
-            }
+            // Display the bids read in one buffered pass
+            displayBids(bids);
             cout << endl;
 
             break;